@@ -0,0 +1,215 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+// Microbenchmark of the vector kernels over the word vector sizes used in practice. Every kernel
+// set the CPU supports runs the negative sampling pattern of one context (a dot product and a dual
+// update per output row, then one axpy) against a table of random rows. The sigmoid kernels are
+// checked against the exact sigmoid, next to the EXP_TABLE_SIZE lookup table of the trainers. The
+// block-buffered ReadWord is timed against the old fgetc tokenizer over the same text
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "lmm-kernel.h"
+#include "lmm-reader.h"
+
+#define ROWS 4096
+#define CALLS 2000000
+#define MAX_EXP 6
+#define EXP_TABLE_SIZE 1000
+#define SIGMOID_POINTS 1200000
+#define TEXT_BYTES (32 << 20)
+
+const char *kernel_sets[] = {"scalar", "avx2", "avx512"};
+long long sizes[] = {50, 100, 200, 300, 500, 1000};
+
+double Now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void FillRandom(real *x, long long n, unsigned long long *next_random) {
+  long long a;
+  for (a = 0; a < n; a++) {
+    *next_random = *next_random * (unsigned long long)25214903917 + 11;
+    x[a] = (((*next_random & 0xFFFF) / (real)65536) - 0.5) / 10;
+  }
+}
+
+// Sigmoid the trainers take from the table: 0 or 1 beyond MAX_EXP, otherwise the entry below x
+double TableSigmoid(real *expTable, real x) {
+  if (x > MAX_EXP) return 1;
+  if (x < -MAX_EXP) return 0;
+  return expTable[(int)((x + MAX_EXP) * (EXP_TABLE_SIZE / MAX_EXP / 2))];
+}
+
+double ExactSigmoid(real x) {
+  if (x > MAX_EXP) return 1;
+  if (x < -MAX_EXP) return 0;
+  return 1 / (1 + exp(-(double)x));
+}
+
+// Largest absolute error of the lookup table and of each sigmoid kernel set over a grid that
+// covers [-MAX_EXP - 1, MAX_EXP + 1], and the time per value of the kernels
+void BenchSigmoid() {
+  long long a, k, reps = 50;
+  real *x, *y, *expTable = (real *)malloc((EXP_TABLE_SIZE + 1) * sizeof(real));
+  double error = 0, start, elapsed;
+  if (posix_memalign((void **)&x, 128, SIGMOID_POINTS * sizeof(real)) ||
+      posix_memalign((void **)&y, 128, SIGMOID_POINTS * sizeof(real))) {printf("Memory allocation failed\n"); exit(1);}
+  for (a = 0; a < EXP_TABLE_SIZE; a++) {
+    expTable[a] = exp((a / (real)EXP_TABLE_SIZE * 2 - 1) * MAX_EXP);
+    expTable[a] = expTable[a] / (expTable[a] + 1);
+  }
+  expTable[EXP_TABLE_SIZE] = expTable[EXP_TABLE_SIZE - 1];
+  for (a = 0; a < SIGMOID_POINTS; a++) x[a] = (a / (real)SIGMOID_POINTS * 2 - 1) * (MAX_EXP + 1);
+  for (a = 0; a < SIGMOID_POINTS; a++) error = fmax(error, fabs(TableSigmoid(expTable, x[a]) - ExactSigmoid(x[a])));
+  printf("\n%8s %12s %14s\n", "sigmoid", "ns/value", "max error");
+  printf("%8s %12s %14.3e\n", "table", "", error);
+  for (k = 0; k < sizeof(kernel_sets) / sizeof(kernel_sets[0]); k++) {
+    if (!SelectKernels(kernel_sets[k])) continue;
+    start = Now();
+    for (a = 0; a < reps; a++) KernelSigmoid(x, y, MAX_EXP, SIGMOID_POINTS);
+    elapsed = Now() - start;
+    error = 0;
+    for (a = 0; a < SIGMOID_POINTS; a++) error = fmax(error, fabs(y[a] - ExactSigmoid(x[a])));
+    printf("%8s %12.3f %14.3e\n", kernel_name, elapsed * 1e9 / reps / SIGMOID_POINTS, error);
+  }
+  free(x);
+  free(y);
+  free(expTable);
+}
+
+// ReadWord as it was before the block reader: one fgetc per character
+void ReadWordFgetc(char *word, FILE *fin) {
+  int a = 0, ch;
+  while (!feof(fin)) {
+    ch = fgetc(fin);
+    if (ch == 13) continue;
+    if ((ch == ' ') || (ch == '\t') || (ch == '\n')) {
+      if (a > 0) {
+        if (ch == '\n') ungetc(ch, fin);
+        break;
+      }
+      if (ch == '\n') {
+        strcpy(word, (char *)"</s>");
+        return;
+      } else continue;
+    }
+    word[a] = ch;
+    a++;
+    if (a >= MAX_STRING - 1) a--;   // Truncate too long words
+  }
+  word[a] = 0;
+}
+
+// Random lines of about 20 lowercase words of 1 to 12 letters, ending with a line break
+void FillText(char *text, long long n, unsigned long long *next_random) {
+  long long a = 0, len;
+  while (a < n - 14) {
+    *next_random = *next_random * (unsigned long long)25214903917 + 11;
+    for (len = 1 + (*next_random >> 16) % 12; len > 0; len--) text[a++] = 'a' + (*next_random >> (16 + 2 * len)) % 26;
+    text[a++] = (*next_random >> 40) % 20 ? ' ' : '\n';
+  }
+  while (a < n) text[a++] = '\n';
+}
+
+// Tokens per second of the fgetc tokenizer and of the block reader, both reading the same text
+// through a stdio stream over memory, so that only the tokenization differs. The token counts and
+// checksums have to agree
+void BenchReader() {
+  char word[MAX_STRING], *text = (char *)malloc(TEXT_BYTES);
+  long long k, tokens[2];
+  unsigned long long next_random = 1, check[2];
+  double start, elapsed[2];
+  struct word_reader *wr;
+  FILE *fin;
+  if (text == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  FillText(text, TEXT_BYTES, &next_random);
+  for (k = 0; k < 2; k++) {
+    fin = fmemopen(text, TEXT_BYTES, "r");
+    if (fin == NULL) {printf("Cannot open the text as a stream\n"); exit(1);}
+    wr = k ? OpenStreamReader(fin) : NULL;
+    tokens[k] = 0;
+    check[k] = 0;
+    start = Now();
+    while (1) {
+      if (k) {
+        ReadWord(word, wr);
+        if (wr->eof) break;
+      } else {
+        ReadWordFgetc(word, fin);
+        if (feof(fin)) break;
+      }
+      tokens[k]++;
+      check[k] = check[k] * 31 + word[0] + strlen(word);
+    }
+    elapsed[k] = Now() - start;
+    if (k) CloseWordReader(wr); else fclose(fin);
+  }
+  printf("\n%8s %12s %12s\n", "reader", "Mtokens/s", "tokens");
+  printf("%8s %12.2f %12lld\n", "fgetc", tokens[0] / elapsed[0] * 1e-6, tokens[0]);
+  printf("%8s %12.2f %12lld%s\n", "block", tokens[1] / elapsed[1] * 1e-6, tokens[1],
+    tokens[0] != tokens[1] || check[0] != check[1] ? "  MISMATCH" : "");
+  free(text);
+}
+
+int main(int argc, char **argv) {
+  long long s, k, a, dim, l2, calls;
+  unsigned long long next_random = 1;
+  real *syn1neg, *neu1, *neu1e, f;
+  double start, elapsed, check, reference = 0;
+  printf("%6s %8s %12s %10s %14s\n", "size", "kernels", "ns/update", "GFLOP/s", "checksum");
+  for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    dim = sizes[s];
+    calls = CALLS * 100 / dim;
+    for (k = 0; k < sizeof(kernel_sets) / sizeof(kernel_sets[0]); k++) {
+      if (!SelectKernels(kernel_sets[k])) continue;
+      if (posix_memalign((void **)&syn1neg, 128, ROWS * dim * sizeof(real)) ||
+          posix_memalign((void **)&neu1, 128, dim * sizeof(real)) ||
+          posix_memalign((void **)&neu1e, 128, dim * sizeof(real))) {printf("Memory allocation failed\n"); exit(1);}
+      next_random = 1;
+      FillRandom(syn1neg, ROWS * dim, &next_random);
+      FillRandom(neu1, dim, &next_random);
+      for (a = 0; a < dim; a++) neu1e[a] = 0;
+      start = Now();
+      for (a = 0; a < calls; a++) {
+        next_random = next_random * (unsigned long long)25214903917 + 11;
+        l2 = (next_random >> 16) % ROWS * dim;
+        f = KernelDot(neu1, syn1neg + l2, dim);
+        KernelDualUpdate(1e-4 * (f > 0 ? -1 : 1), neu1e, syn1neg + l2, neu1, dim);
+        if (a % 6 == 5) {
+          KernelAxpy(-1e-3, neu1e, neu1, dim);
+          for (l2 = 0; l2 < dim; l2++) neu1e[l2] = 0;
+        }
+      }
+      elapsed = Now() - start;
+      // Kernel sets round differently, so their checksums only have to be close to the scalar one
+      check = 0;
+      for (a = 0; a < ROWS * dim; a++) check += (double)syn1neg[a] * syn1neg[a];
+      if (k == 0) reference = check;
+      printf("%6lld %8s %12.2f %10.2f %14.6f%s\n", dim, kernel_name, elapsed * 1e9 / calls,
+        6.0 * dim * calls / elapsed * 1e-9, check, fabs(check - reference) > 1e-3 * reference ? "  MISMATCH" : "");
+      free(syn1neg);
+      free(neu1);
+      free(neu1e);
+    }
+  }
+  BenchSigmoid();
+  BenchReader();
+  return 0;
+}
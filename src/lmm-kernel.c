@@ -0,0 +1,400 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include <string.h>
+#include <math.h>
+#include "lmm-kernel.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define LMM_X86 1
+#include <immintrin.h>
+#endif
+
+// The scalar kernels keep the order of the original loops, so they give the same results
+real DotScalar(const real *x, const real *y, long long n) {
+  long long c;
+  real f = 0;
+  for (c = 0; c < n; c++) f += x[c] * y[c];
+  return f;
+}
+
+void AxpyScalar(real a, const real *x, real *y, long long n) {
+  long long c;
+  for (c = 0; c < n; c++) y[c] += a * x[c];
+}
+
+void DualUpdateScalar(real g, real *e, real *w, const real *h, long long n) {
+  long long c;
+  for (c = 0; c < n; c++) e[c] += g * w[c];
+  for (c = 0; c < n; c++) w[c] += g * h[c];
+}
+
+void DotBatchScalar(const real *x, real *const *rows, real *out, long long k, long long n) {
+  long long j;
+  for (j = 0; j < k; j++) out[j] = DotScalar(x, rows[j], n);
+}
+
+void DualUpdateBatchScalar(const real *g, real *e, real *const *rows, const real *h, long long k, long long n) {
+  long long j;
+  for (j = 0; j < k; j++) DualUpdateScalar(g[j], e, rows[j], h, n);
+}
+
+void CombineScalar(const real *g, real *const *rows, real *y, long long k, long long n) {
+  long long j;
+  for (j = 0; j < k; j++) AxpyScalar(g[j], rows[j], y, n);
+}
+
+// The sigmoid kernels evaluate exp(-x) as 2^n * p(r) with |r| <= ln(2) / 2 and the degree 6
+// polynomial p of the Cephes expf, so every set gives the same values up to rounding
+#define EXP_LN2_HI 0.693359375f
+#define EXP_LN2_LO -2.12194440e-4f
+#define EXP_P0 1.9875691500e-4f
+#define EXP_P1 1.3981999507e-3f
+#define EXP_P2 8.3334519073e-3f
+#define EXP_P3 4.1665795894e-2f
+#define EXP_P4 1.6666665459e-1f
+#define EXP_P5 5.0000001201e-1f
+
+void SigmoidScalar(const real *x, real *y, real m, long long k) {
+  long long j;
+  real t, n, r, p;
+  for (j = 0; j < k; j++) {
+    if (x[j] > m) {y[j] = 1; continue;}
+    if (x[j] < -m) {y[j] = 0; continue;}
+    t = -x[j];
+    n = floorf(t * 1.44269504f + 0.5f);
+    r = t - n * EXP_LN2_HI - n * EXP_LN2_LO;
+    p = ((((EXP_P0 * r + EXP_P1) * r + EXP_P2) * r + EXP_P3) * r + EXP_P4) * r + EXP_P5;
+    p = p * r * r + r + 1;
+    y[j] = 1 / (1 + ldexpf(p, (int)n));
+  }
+}
+
+#ifdef LMM_X86
+__attribute__((target("avx2,fma")))
+real DotAvx2(const real *x, const real *y, long long n) {
+  long long c = 0;
+  real f;
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+  __m128 s;
+  for (; c + 16 <= n; c += 16) {
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + c), _mm256_loadu_ps(y + c), s0);
+    s1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + c + 8), _mm256_loadu_ps(y + c + 8), s1);
+  }
+  if (c + 8 <= n) {
+    s0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + c), _mm256_loadu_ps(y + c), s0);
+    c += 8;
+  }
+  s0 = _mm256_add_ps(s0, s1);
+  s = _mm_add_ps(_mm256_castps256_ps128(s0), _mm256_extractf128_ps(s0, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  f = _mm_cvtss_f32(s);
+  for (; c < n; c++) f += x[c] * y[c];
+  return f;
+}
+
+__attribute__((target("avx2,fma")))
+void AxpyAvx2(real a, const real *x, real *y, long long n) {
+  long long c = 0;
+  __m256 va = _mm256_set1_ps(a);
+  for (; c + 8 <= n; c += 8)
+    _mm256_storeu_ps(y + c, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + c), _mm256_loadu_ps(y + c)));
+  for (; c < n; c++) y[c] += a * x[c];
+}
+
+__attribute__((target("avx2,fma")))
+void DualUpdateAvx2(real g, real *e, real *w, const real *h, long long n) {
+  long long c = 0;
+  __m256 vg = _mm256_set1_ps(g), vw;
+  for (; c + 8 <= n; c += 8) {
+    vw = _mm256_loadu_ps(w + c);
+    _mm256_storeu_ps(e + c, _mm256_fmadd_ps(vg, vw, _mm256_loadu_ps(e + c)));
+    _mm256_storeu_ps(w + c, _mm256_fmadd_ps(vg, _mm256_loadu_ps(h + c), vw));
+  }
+  for (; c < n; c++) {
+    e[c] += g * w[c];
+    w[c] += g * h[c];
+  }
+}
+
+// The batched kernels load x (or e and h) once per chunk and run it against four rows at a time
+__attribute__((target("avx2,fma")))
+static inline real ReduceAvx2(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+__attribute__((target("avx2,fma")))
+void DotBatchAvx2(const real *x, real *const *rows, real *out, long long k, long long n) {
+  long long j = 0, c, i;
+  __m256 s0, s1, s2, s3, vx;
+  for (; j + 4 <= k; j += 4) {
+    s0 = s1 = s2 = s3 = _mm256_setzero_ps();
+    for (c = 0; c + 8 <= n; c += 8) {
+      vx = _mm256_loadu_ps(x + c);
+      s0 = _mm256_fmadd_ps(vx, _mm256_loadu_ps(rows[j] + c), s0);
+      s1 = _mm256_fmadd_ps(vx, _mm256_loadu_ps(rows[j + 1] + c), s1);
+      s2 = _mm256_fmadd_ps(vx, _mm256_loadu_ps(rows[j + 2] + c), s2);
+      s3 = _mm256_fmadd_ps(vx, _mm256_loadu_ps(rows[j + 3] + c), s3);
+    }
+    out[j] = ReduceAvx2(s0);
+    out[j + 1] = ReduceAvx2(s1);
+    out[j + 2] = ReduceAvx2(s2);
+    out[j + 3] = ReduceAvx2(s3);
+    for (; c < n; c++) for (i = 0; i < 4; i++) out[j + i] += x[c] * rows[j + i][c];
+  }
+  for (; j < k; j++) out[j] = DotAvx2(x, rows[j], n);
+}
+
+__attribute__((target("avx2,fma")))
+void DualUpdateBatchAvx2(const real *g, real *e, real *const *rows, const real *h, long long k, long long n) {
+  long long j, c = 0;
+  __m256 ve, vh, vw, vg;
+  for (; c + 8 <= n; c += 8) {
+    ve = _mm256_loadu_ps(e + c);
+    vh = _mm256_loadu_ps(h + c);
+    for (j = 0; j < k; j++) {
+      vg = _mm256_set1_ps(g[j]);
+      vw = _mm256_loadu_ps(rows[j] + c);
+      ve = _mm256_fmadd_ps(vg, vw, ve);
+      _mm256_storeu_ps(rows[j] + c, _mm256_fmadd_ps(vg, vh, vw));
+    }
+    _mm256_storeu_ps(e + c, ve);
+  }
+  for (; c < n; c++) for (j = 0; j < k; j++) {
+    e[c] += g[j] * rows[j][c];
+    rows[j][c] += g[j] * h[c];
+  }
+}
+
+__attribute__((target("avx2,fma")))
+void CombineAvx2(const real *g, real *const *rows, real *y, long long k, long long n) {
+  long long j, c = 0;
+  __m256 vy;
+  for (; c + 8 <= n; c += 8) {
+    vy = _mm256_loadu_ps(y + c);
+    for (j = 0; j < k; j++) vy = _mm256_fmadd_ps(_mm256_set1_ps(g[j]), _mm256_loadu_ps(rows[j] + c), vy);
+    _mm256_storeu_ps(y + c, vy);
+  }
+  for (; c < n; c++) for (j = 0; j < k; j++) y[c] += g[j] * rows[j][c];
+}
+
+__attribute__((target("avx2,fma")))
+void SigmoidAvx2(const real *x, real *y, real m, long long k) {
+  long long j = 0;
+  __m256 vm = _mm256_set1_ps(m), vx, t, n, r, p, one = _mm256_set1_ps(1);
+  __m256i e;
+  for (; j + 8 <= k; j += 8) {
+    vx = _mm256_loadu_ps(x + j);
+    t = _mm256_max_ps(_mm256_min_ps(_mm256_sub_ps(_mm256_setzero_ps(), vx), vm), _mm256_sub_ps(_mm256_setzero_ps(), vm));
+    n = _mm256_round_ps(_mm256_mul_ps(t, _mm256_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_HI), t);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(EXP_LN2_LO), r);
+    p = _mm256_fmadd_ps(_mm256_set1_ps(EXP_P0), r, _mm256_set1_ps(EXP_P1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(EXP_P5));
+    p = _mm256_add_ps(_mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r), one);
+    e = _mm256_slli_epi32(_mm256_cvtps_epi32(n), 23);
+    p = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(p), e));
+    p = _mm256_div_ps(one, _mm256_add_ps(one, p));
+    p = _mm256_blendv_ps(p, one, _mm256_cmp_ps(vx, vm, _CMP_GT_OQ));
+    p = _mm256_blendv_ps(p, _mm256_setzero_ps(), _mm256_cmp_ps(vx, _mm256_sub_ps(_mm256_setzero_ps(), vm), _CMP_LT_OQ));
+    _mm256_storeu_ps(y + j, p);
+  }
+  SigmoidScalar(x + j, y + j, m, k - j);
+}
+
+// The AVX-512 kernels handle the tail with masked loads and stores
+__attribute__((target("avx512f")))
+real DotAvx512(const real *x, const real *y, long long n) {
+  long long c = 0;
+  __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps();
+  __mmask16 m;
+  for (; c + 32 <= n; c += 32) {
+    s0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + c), _mm512_loadu_ps(y + c), s0);
+    s1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + c + 16), _mm512_loadu_ps(y + c + 16), s1);
+  }
+  for (; c < n; c += 16) {
+    m = n - c >= 16 ? 0xFFFF : (__mmask16)((1u << (n - c)) - 1);
+    s0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, x + c), _mm512_maskz_loadu_ps(m, y + c), s0);
+  }
+  return _mm512_reduce_add_ps(_mm512_add_ps(s0, s1));
+}
+
+__attribute__((target("avx512f")))
+void AxpyAvx512(real a, const real *x, real *y, long long n) {
+  long long c = 0;
+  __m512 va = _mm512_set1_ps(a);
+  __mmask16 m;
+  for (; c + 16 <= n; c += 16)
+    _mm512_storeu_ps(y + c, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + c), _mm512_loadu_ps(y + c)));
+  if (c < n) {
+    m = (__mmask16)((1u << (n - c)) - 1);
+    _mm512_mask_storeu_ps(y + c, m, _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(m, x + c), _mm512_maskz_loadu_ps(m, y + c)));
+  }
+}
+
+__attribute__((target("avx512f")))
+void DualUpdateAvx512(real g, real *e, real *w, const real *h, long long n) {
+  long long c = 0;
+  __m512 vg = _mm512_set1_ps(g), vw;
+  __mmask16 m;
+  for (; c + 16 <= n; c += 16) {
+    vw = _mm512_loadu_ps(w + c);
+    _mm512_storeu_ps(e + c, _mm512_fmadd_ps(vg, vw, _mm512_loadu_ps(e + c)));
+    _mm512_storeu_ps(w + c, _mm512_fmadd_ps(vg, _mm512_loadu_ps(h + c), vw));
+  }
+  if (c < n) {
+    m = (__mmask16)((1u << (n - c)) - 1);
+    vw = _mm512_maskz_loadu_ps(m, w + c);
+    _mm512_mask_storeu_ps(e + c, m, _mm512_fmadd_ps(vg, vw, _mm512_maskz_loadu_ps(m, e + c)));
+    _mm512_mask_storeu_ps(w + c, m, _mm512_fmadd_ps(vg, _mm512_maskz_loadu_ps(m, h + c), vw));
+  }
+}
+
+__attribute__((target("avx512f")))
+void DotBatchAvx512(const real *x, real *const *rows, real *out, long long k, long long n) {
+  long long j = 0, c;
+  __m512 s0, s1, s2, s3, vx;
+  __mmask16 m;
+  for (; j + 4 <= k; j += 4) {
+    s0 = s1 = s2 = s3 = _mm512_setzero_ps();
+    for (c = 0; c < n; c += 16) {
+      m = n - c >= 16 ? 0xFFFF : (__mmask16)((1u << (n - c)) - 1);
+      vx = _mm512_maskz_loadu_ps(m, x + c);
+      s0 = _mm512_fmadd_ps(vx, _mm512_maskz_loadu_ps(m, rows[j] + c), s0);
+      s1 = _mm512_fmadd_ps(vx, _mm512_maskz_loadu_ps(m, rows[j + 1] + c), s1);
+      s2 = _mm512_fmadd_ps(vx, _mm512_maskz_loadu_ps(m, rows[j + 2] + c), s2);
+      s3 = _mm512_fmadd_ps(vx, _mm512_maskz_loadu_ps(m, rows[j + 3] + c), s3);
+    }
+    out[j] = _mm512_reduce_add_ps(s0);
+    out[j + 1] = _mm512_reduce_add_ps(s1);
+    out[j + 2] = _mm512_reduce_add_ps(s2);
+    out[j + 3] = _mm512_reduce_add_ps(s3);
+  }
+  for (; j < k; j++) out[j] = DotAvx512(x, rows[j], n);
+}
+
+__attribute__((target("avx512f")))
+void DualUpdateBatchAvx512(const real *g, real *e, real *const *rows, const real *h, long long k, long long n) {
+  long long j, c;
+  __m512 ve, vh, vw, vg;
+  __mmask16 m;
+  for (c = 0; c < n; c += 16) {
+    m = n - c >= 16 ? 0xFFFF : (__mmask16)((1u << (n - c)) - 1);
+    ve = _mm512_maskz_loadu_ps(m, e + c);
+    vh = _mm512_maskz_loadu_ps(m, h + c);
+    for (j = 0; j < k; j++) {
+      vg = _mm512_set1_ps(g[j]);
+      vw = _mm512_maskz_loadu_ps(m, rows[j] + c);
+      ve = _mm512_fmadd_ps(vg, vw, ve);
+      _mm512_mask_storeu_ps(rows[j] + c, m, _mm512_fmadd_ps(vg, vh, vw));
+    }
+    _mm512_mask_storeu_ps(e + c, m, ve);
+  }
+}
+
+__attribute__((target("avx512f")))
+void CombineAvx512(const real *g, real *const *rows, real *y, long long k, long long n) {
+  long long j, c;
+  __m512 vy;
+  __mmask16 m;
+  for (c = 0; c < n; c += 16) {
+    m = n - c >= 16 ? 0xFFFF : (__mmask16)((1u << (n - c)) - 1);
+    vy = _mm512_maskz_loadu_ps(m, y + c);
+    for (j = 0; j < k; j++) vy = _mm512_fmadd_ps(_mm512_set1_ps(g[j]), _mm512_maskz_loadu_ps(m, rows[j] + c), vy);
+    _mm512_mask_storeu_ps(y + c, m, vy);
+  }
+}
+
+__attribute__((target("avx512f")))
+void SigmoidAvx512(const real *x, real *y, real m, long long k) {
+  long long j;
+  __m512 vm = _mm512_set1_ps(m), vx, t, n, r, p, one = _mm512_set1_ps(1);
+  __mmask16 l;
+  for (j = 0; j < k; j += 16) {
+    l = k - j >= 16 ? 0xFFFF : (__mmask16)((1u << (k - j)) - 1);
+    vx = _mm512_maskz_loadu_ps(l, x + j);
+    t = _mm512_max_ps(_mm512_min_ps(_mm512_sub_ps(_mm512_setzero_ps(), vx), vm), _mm512_sub_ps(_mm512_setzero_ps(), vm));
+    n = _mm512_roundscale_ps(_mm512_mul_ps(t, _mm512_set1_ps(1.44269504f)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_HI), t);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(EXP_LN2_LO), r);
+    p = _mm512_fmadd_ps(_mm512_set1_ps(EXP_P0), r, _mm512_set1_ps(EXP_P1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(EXP_P5));
+    p = _mm512_add_ps(_mm512_fmadd_ps(p, _mm512_mul_ps(r, r), r), one);
+    p = _mm512_div_ps(one, _mm512_add_ps(one, _mm512_scalef_ps(p, n)));
+    p = _mm512_mask_mov_ps(p, _mm512_cmp_ps_mask(vx, vm, _CMP_GT_OQ), one);
+    p = _mm512_mask_mov_ps(p, _mm512_cmp_ps_mask(vx, _mm512_sub_ps(_mm512_setzero_ps(), vm), _CMP_LT_OQ), _mm512_setzero_ps());
+    _mm512_mask_storeu_ps(y + j, l, p);
+  }
+}
+#endif
+
+real (*KernelDot)(const real *x, const real *y, long long n) = DotScalar;
+void (*KernelAxpy)(real a, const real *x, real *y, long long n) = AxpyScalar;
+void (*KernelDualUpdate)(real g, real *e, real *w, const real *h, long long n) = DualUpdateScalar;
+void (*KernelDotBatch)(const real *x, real *const *rows, real *out, long long k, long long n) = DotBatchScalar;
+void (*KernelDualUpdateBatch)(const real *g, real *e, real *const *rows, const real *h, long long k, long long n) = DualUpdateBatchScalar;
+void (*KernelCombine)(const real *g, real *const *rows, real *y, long long k, long long n) = CombineScalar;
+void (*KernelSigmoid)(const real *x, real *y, real m, long long k) = SigmoidScalar;
+const char *kernel_name = "scalar";
+
+int SelectKernels(const char *name) {
+  int is_auto = !strcmp(name, "auto");
+#ifdef LMM_X86
+  __builtin_cpu_init();
+  if ((is_auto || !strcmp(name, "avx512")) && __builtin_cpu_supports("avx512f")) {
+    KernelDot = DotAvx512;
+    KernelAxpy = AxpyAvx512;
+    KernelDualUpdate = DualUpdateAvx512;
+    KernelDotBatch = DotBatchAvx512;
+    KernelDualUpdateBatch = DualUpdateBatchAvx512;
+    KernelCombine = CombineAvx512;
+    KernelSigmoid = SigmoidAvx512;
+    kernel_name = "avx512";
+    return 1;
+  }
+  if ((is_auto || !strcmp(name, "avx2")) && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    KernelDot = DotAvx2;
+    KernelAxpy = AxpyAvx2;
+    KernelDualUpdate = DualUpdateAvx2;
+    KernelDotBatch = DotBatchAvx2;
+    KernelDualUpdateBatch = DualUpdateBatchAvx2;
+    KernelCombine = CombineAvx2;
+    KernelSigmoid = SigmoidAvx2;
+    kernel_name = "avx2";
+    return 1;
+  }
+#endif
+  if (is_auto || !strcmp(name, "scalar")) {
+    KernelDot = DotScalar;
+    KernelAxpy = AxpyScalar;
+    KernelDualUpdate = DualUpdateScalar;
+    KernelDotBatch = DotBatchScalar;
+    KernelDualUpdateBatch = DualUpdateBatchScalar;
+    KernelCombine = CombineScalar;
+    KernelSigmoid = SigmoidScalar;
+    kernel_name = "scalar";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,47 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+// Vector kernels of the training loops of the lmm engine (and of lmm-a, lmm-s and lmm-m, which are
+// built from it) and of lmm-bench. Each kernel has a scalar version and AVX2 / AVX-512 versions;
+// SelectKernels picks one set at run time
+
+#ifndef LMM_KERNEL_H
+#define LMM_KERNEL_H
+
+typedef float real;                    // Precision of float numbers
+
+// Returns x . y
+extern real (*KernelDot)(const real *x, const real *y, long long n);
+// y += a * x
+extern void (*KernelAxpy)(real a, const real *x, real *y, long long n);
+// e += g * w, then w += g * h, using the old w for e. This is the update that follows the dot
+// product of h and w for one output node
+extern void (*KernelDualUpdate)(real g, real *e, real *w, const real *h, long long n);
+// out[j] = x . rows[j] for j < k
+extern void (*KernelDotBatch)(const real *x, real *const *rows, real *out, long long k, long long n);
+// KernelDualUpdate(g[j], e, rows[j], h, n) for j < k in order. The rows must be distinct
+extern void (*KernelDualUpdateBatch)(const real *g, real *e, real *const *rows, const real *h, long long k, long long n);
+// y += g[j] * rows[j] for j < k
+extern void (*KernelCombine)(const real *g, real *const *rows, real *y, long long k, long long n);
+// y[j] = 1 / (1 + exp(-x[j])) for |x[j]| <= m, 1 above m and 0 below -m, for j < k. x and y may
+// be the same array
+extern void (*KernelSigmoid)(const real *x, real *y, real m, long long k);
+
+extern const char *kernel_name;
+
+// name is "auto" (the widest set the CPU supports), "scalar", "avx2" or "avx512".
+// Returns 0 if the CPU or the build does not support that set, and leaves the kernels unchanged
+int SelectKernels(const char *name);
+
+#endif
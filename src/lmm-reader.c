@@ -0,0 +1,87 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "lmm-reader.h"
+
+struct word_reader *OpenWordReader(char *file) {
+  FILE *fin = fopen(file, "rb");
+  if (fin == NULL) return NULL;
+  return OpenStreamReader(fin);
+}
+
+struct word_reader *OpenStreamReader(FILE *fin) {
+  struct word_reader *wr = (struct word_reader *)malloc(sizeof(struct word_reader));
+  wr->fin = fin;
+  wr->buf = (char *)malloc(READ_BUFFER_SIZE);
+  wr->ids = NULL;
+  wr->pos = 0;
+  wr->len = 0;
+  wr->eof = 0;
+  return wr;
+}
+
+// Moves the reader to the given byte offset and drops the buffered block
+void SeekWordReader(struct word_reader *wr, long long offset) {
+  fseek(wr->fin, offset, SEEK_SET);
+  wr->pos = 0;
+  wr->len = 0;
+  wr->eof = 0;
+}
+
+void CloseWordReader(struct word_reader *wr) {
+  if (wr->fin != NULL) {
+    fclose(wr->fin);
+    free(wr->buf);
+  }
+  free(wr);
+}
+
+// Loads the next block of the file; returns 0 at the end of file
+int FillWordReader(struct word_reader *wr) {
+  if (wr->fin == NULL) return 0; // a mapped range is a single block
+  wr->len = fread(wr->buf, 1, READ_BUFFER_SIZE, wr->fin);
+  wr->pos = 0;
+  return wr->len > 0;
+}
+
+// Reads a single word from a file, assuming space + tab + EOL to be word boundaries
+void ReadWord(char *word, struct word_reader *wr) {
+  int a = 0;
+  char ch;
+  while (1) {
+    if (wr->pos >= wr->len && !FillWordReader(wr)) {
+      wr->eof = 1;
+      break;
+    }
+    ch = wr->buf[wr->pos++];
+    if (ch == 13) continue;
+    if ((ch == ' ') || (ch == '\t') || (ch == '\n')) {
+      if (a > 0) {
+        if (ch == '\n') wr->pos--; // leave the newline in the buffer, it is returned as </s> next time
+        break;
+      }
+      if (ch == '\n') {
+        strcpy(word, (char *)"</s>");
+        return;
+      } else continue;
+    }
+    word[a] = ch;
+    a++;
+    if (a >= MAX_STRING - 1) a--;   // Truncate too long words
+  }
+  word[a] = 0; ////ASCII '\0'
+}
@@ -0,0 +1,49 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+
+// Block-buffered word reader of the training and vocabulary files, shared by lmm and lmm-bench.
+// ReadWord scans a block in memory instead of calling fgetc for every character
+
+#ifndef LMM_READER_H
+#define LMM_READER_H
+
+#include <stdio.h>
+
+#define MAX_STRING 100
+#define READ_BUFFER_SIZE 1048576
+
+// Block-buffered reader over a text file; each training thread owns one
+struct word_reader {
+  FILE *fin;
+  char *buf;
+  int *ids;           // when set, the reader walks a slice of the pre-tokenized corpus instead of text
+  long long pos, len; // read cursor and number of valid bytes in buf (or words in ids)
+  int eof;
+};
+
+// Returns NULL if the file cannot be opened
+struct word_reader *OpenWordReader(char *file);
+// Reader over an open stream, which CloseWordReader closes
+struct word_reader *OpenStreamReader(FILE *fin);
+// Moves the reader to the given byte offset and drops the buffered block
+void SeekWordReader(struct word_reader *wr, long long offset);
+void CloseWordReader(struct word_reader *wr);
+// Loads the next block of the file; returns 0 at the end of file
+int FillWordReader(struct word_reader *wr);
+// Reads a single word into word (at most MAX_STRING bytes), assuming space + tab + EOL to be word
+// boundaries. A line break is returned as </s>; wr->eof is set at the end of the input
+void ReadWord(char *word, struct word_reader *wr);
+
+#endif
@@ -0,0 +1,275 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+// Training loop of lmm.c, included once per morpheme strategy with STRATEGY(name) giving the
+// name of each function for that strategy and STRATEGY_MODEL its MODEL_ constant. Tests of
+// STRATEGY_MODEL are constant, so every copy keeps only the code of its own strategy.
+// There is no include guard on purpose
+
+void STRATEGY(ScatterFlush)(struct scatter *sc, real *neu1e) {
+  int i;
+  for (i = 0; i < sc->size; i++) KernelAxpy(sc->count[i], neu1e, syn0 + sc->row[i] * dim, dim);
+  sc->size = 0;
+}
+
+void STRATEGY(ScatterAdd)(struct scatter *sc, long long row, real *neu1e) {
+  int i;
+  for (i = 0; i < sc->size; i++) if (sc->row[i] == row) {
+    sc->count[i]++;
+    return;
+  }
+  if (sc->size == MAX_SCATTER) STRATEGY(ScatterFlush)(sc, neu1e);
+  sc->row[sc->size] = row;
+  sc->count[sc->size] = 1;
+  sc->size++;
+}
+
+// Adds a context word to sc with the morphemes its input was composed from: all of them for models A
+// and S, the prefix, root and suffix in pick[0 .. 2] (-1 if none) for model M
+void STRATEGY(ScatterWord)(struct scatter *sc, long long last_word, real *neu1e, long long *pick) {
+  long long t;
+  int curIdx;
+  STRATEGY(ScatterAdd)(sc, last_word, neu1e);
+  //modification begin
+  if (STRATEGY_MODEL == MODEL_M) {
+    for (t = 0; t < 3; t++) if (pick[t] >= 0) STRATEGY(ScatterAdd)(sc, pick[t], neu1e);
+    return;
+  }
+  // every prefix, root and suffix gets the same update, so the whole range is walked at once
+  for(curIdx = morph_offset[3 * last_word]; curIdx < morph_offset[3 * last_word + 3]; curIdx++){
+    long long morphemeWord = morph_index[curIdx];
+    STRATEGY(ScatterAdd)(sc, morphemeWord, neu1e);
+  }
+  // so the mean of those morphemes moves by neu1e as well; other words sharing them wait for the next
+  // sweep. A batch recomputes the means of its context words instead, see FlushBatch
+  if (STRATEGY_MODEL == MODEL_A && compose_refresh != 0 && batch <= 1 && morph_offset[3 * last_word + 3] > morph_offset[3 * last_word])
+    KernelAxpy(1, neu1e, composed + last_word * dim, dim);
+  //modification end
+}
+
+// hidden -> in: adds the error neu1e of the CBOW center at sentence_position, whose window was
+// reduced by b, to its context words and their morphemes. choice[3 * a .. 3 * a + 2] are the prefix,
+// root and suffix picked for the context word in window slot a by the in -> hidden pass (-1 if none)
+void STRATEGY(UpdateContext)(long long *sen, long long sentence_length, long long sentence_position, long long b, real *neu1e, long long *choice) {
+  long long a, c, last_word;
+  struct scatter sc;
+  sc.size = 0;
+  for (a = b; a < window * 2 + 1 - b; a++) if (a != window) {
+    c = sentence_position - window + a;
+    if (c < 0) continue;
+    if (c >= sentence_length) continue;
+    last_word = sen[c];
+    if (last_word == -1) continue;
+    STRATEGY(ScatterWord)(&sc, last_word, neu1e, choice + 3 * a);
+  }
+  STRATEGY(ScatterFlush)(&sc, neu1e);
+}
+
+// hidden -> in for one skip-gram pair: adds neu1e to the context word and the morphemes in pick
+void STRATEGY(UpdateWord)(long long last_word, real *neu1e, long long *pick) {
+  struct scatter sc;
+  sc.size = 0;
+  STRATEGY(ScatterWord)(&sc, last_word, neu1e, pick);
+  STRATEGY(ScatterFlush)(&sc, neu1e);
+}
+
+void STRATEGY(FlushBatch)(struct cbow_batch *bt, long long *sen, long long sentence_length, unsigned long long *next_random) {
+  long long i, first, last;
+  if (bt->size == 0) return;
+  TrainBatch(bt, next_random);
+  for (i = 0; i < bt->size; i++) STRATEGY(UpdateContext)(sen, sentence_length, bt->position[i], bt->reduced[i], bt->e_rows[i], bt->choice + i * 3 * (window * 2 + 1));
+  //modification begin
+  // The errors of a batch are all taken against the composed vectors as they were before it. Moving
+  // each context word's mean by every error on top of that diverges, so the means of the words the
+  // batch updated are recomputed from their morphemes (the centers are consecutive in sen)
+  if (STRATEGY_MODEL == MODEL_A && compose_refresh != 0) {
+    first = bt->position[0] - window > 0 ? bt->position[0] - window : 0;
+    last = bt->position[bt->size - 1] + window < sentence_length - 1 ? bt->position[bt->size - 1] + window : sentence_length - 1;
+    for (i = first; i <= last; i++) if (sen[i] != -1) RefreshComposed(sen[i], sen[i] + 1, bt->sum);
+  }
+  //modification end
+  bt->size = 0;
+}
+
+void *STRATEGY(TrainModelThread)(void *id) {
+  long long a, b, cw, word, last_word, sentence_length = 0, sentence_position = 0;
+  long long word_count = 0, last_word_count = 0, sen[MAX_SENTENCE_LENGTH + 1];
+  long long c, local_iter = iter;
+  unsigned long long next_random = (long long)id;
+  clock_t now;
+  BindThread((long long)id); // before the thread's buffers are allocated and touched
+  real *neu1 = (real *)calloc(dim, sizeof(real)); // x_w
+  real *neu1e = (real *)calloc(dim, sizeof(real)); // e
+  long long *neg_targets = (long long *)malloc((negative + 1) * sizeof(long long)); // rows of a negative sampling block
+  real **neg_rows = (real **)malloc((negative + 1) * sizeof(real *));
+  real *neg_g = (real *)malloc((negative + 1) * sizeof(real));
+  real **hs_rows = (real **)malloc(MAX_CODE_LENGTH * sizeof(real *)); // nodes of a hierarchical softmax path
+  real *hs_g = (real *)malloc(2 * MAX_CODE_LENGTH * sizeof(real));
+  struct neg_ring ring = {(long long *)malloc(ns_buffer * sizeof(long long)), ns_buffer, ns_buffer};
+  struct cbow_batch bt;
+  //modification begin
+  real *morpheme = (real *)calloc(dim, sizeof(real));
+  real *comp = (real *)calloc(3 * dim, sizeof(real)); // prefix, root and suffix sums of ComposeWord
+  // morphemes picked for each window slot, kept per thread for the hidden -> in pass
+  long long *morph_choice = (long long *)malloc(3 * (window * 2 + 1) * sizeof(long long)), *pick;
+  //modification end
+  struct word_reader *wr = OpenThreadReader((long long)id);
+  if (batch > 1) InitBatch(&bt);
+  //modification begin
+  long long weight_epoch = 0, compose_epoch = 0;
+  long long compose_first = vocab_size * (long long)id / num_threads, compose_last = vocab_size * ((long long)id + 1) / num_threads;
+  if (STRATEGY_MODEL != MODEL_A && weight_refresh != 0) RefreshMorphemeWeights((long long)id);
+  //modification end
+  while (1) {
+    if (word_count - last_word_count > 10000) {
+      word_count_actual += word_count - last_word_count;
+      last_word_count = word_count;
+      if ((debug_mode > 1)) {
+        now=clock();
+        printf("%cAlpha: %f  Progress: %.2f%%  Words/thread/sec: %.2fk  ", 13, alpha,
+         word_count_actual / (real)(iter * train_words + 1) * 100,
+         word_count_actual / ((real)(now - start + 1) / (real)CLOCKS_PER_SEC * 1000));
+        fflush(stdout);
+      }
+      alpha = starting_alpha * (1 - word_count_actual / (real)(iter * train_words + 1)); // update learning rate
+      if (alpha < starting_alpha * 0.0001) alpha = starting_alpha * 0.0001; // guarantee the minimum learning rate
+      //modification begin
+      // every thread refreshes its share of the composed vectors, together they sweep the whole array
+      if (STRATEGY_MODEL == MODEL_A && compose_refresh > 0 && word_count_actual / compose_refresh != compose_epoch) {
+        compose_epoch = word_count_actual / compose_refresh;
+        RefreshComposed(compose_first, compose_last, morpheme);
+      }
+      if (STRATEGY_MODEL != MODEL_A && weight_refresh > 0 && word_count_actual / weight_refresh != weight_epoch) {
+        weight_epoch = word_count_actual / weight_refresh;
+        RefreshMorphemeWeights((long long)id);
+      }
+      //modification end
+    }
+    if (sentence_length == 0) {
+      while (1) {
+        word = ReadWordIndex(wr);
+        if (wr->eof) break;
+        if (word == -1) continue;
+        word_count++;
+        if (word == 0) break;
+        // The subsampling randomly discards frequent words while keeping the ranking same
+        if (sample > 0) {
+          next_random = next_random * (unsigned long long)25214903917 + 11;
+          if ((next_random & 0xFFFF) > vocab_keep[word]) continue;
+        }
+        sen[sentence_length] = word;
+        sentence_length++;
+        if (sentence_length >= MAX_SENTENCE_LENGTH) break;
+      }
+      sentence_position = 0;
+    }
+    // Cached and mapped parts end exactly at the next thread's first sentence, so only a stdio reader stops on the word count
+    if (wr->eof || (wr->fin != NULL && word_count > train_words / num_threads)) {
+      word_count_actual += word_count - last_word_count;
+      local_iter--;
+      if (local_iter == 0) break;
+      if (STRATEGY_MODEL == MODEL_A && compose_refresh < 0) RefreshComposed(compose_first, compose_last, morpheme);
+      if (STRATEGY_MODEL != MODEL_A && weight_refresh < 0) RefreshMorphemeWeights((long long)id);
+      word_count = 0;
+      last_word_count = 0;
+      sentence_length = 0;
+      ResetThreadReader(wr, (long long)id);
+      continue;
+    }
+    word = sen[sentence_position];
+    if (word == -1) continue;
+    for (c = 0; c < dim; c++) neu1[c] = 0;
+    for (c = 0; c < dim; c++) neu1e[c] = 0;
+    next_random = next_random * (unsigned long long)25214903917 + 11;
+    b = next_random % window;
+
+    if (cbow) {  //train the cbow architecture
+      // in -> hidden
+      cw = 0;
+      pick = batch > 1 ? bt.choice + bt.size * 3 * (window * 2 + 1) : morph_choice;
+      for (a = b; a < window * 2 + 1 - b; a++){ 
+        if (a != window) {
+          c = sentence_position - window + a;
+          if (c < 0) continue;
+          if (c >= sentence_length) continue;
+          last_word = sen[c];
+          if (last_word == -1) continue;
+
+          //modification begin
+          STRATEGY(ComposeWord)(last_word, morpheme, comp, pick + 3 * a);
+          for (c = 0; c < dim; c++) neu1[c] += morpheme[c];
+	        //modification end
+          cw++;
+        }
+      }
+      if (cw) { // CBOW
+        for (c = 0; c < dim; c++) neu1[c] /= cw;
+	      // HIERACHICAL SOFTMAX
+        if (hs) TrainHierarchical(neu1, neu1e, word, hs_rows, hs_g);
+        // NEGATIVE SAMPLING
+        if (negative > 0 && batch <= 1) TrainNegatives(neu1, neu1e, word, &ring, &next_random, neg_targets, neg_rows, neg_g);
+        // hidden -> in
+        if (batch > 1) {
+          // the centers of a batch go through the output layer together
+          memcpy(bt.h_rows[bt.size], neu1, dim * sizeof(real));
+          memcpy(bt.e_rows[bt.size], neu1e, dim * sizeof(real));
+          bt.word[bt.size] = word;
+          bt.position[bt.size] = sentence_position;
+          bt.reduced[bt.size] = b;
+          bt.size++;
+          if (bt.size == batch) STRATEGY(FlushBatch)(&bt, sen, sentence_length, &next_random);
+        } else STRATEGY(UpdateContext)(sen, sentence_length, sentence_position, b, neu1e, morph_choice);
+      }
+    } else {  //train skip-gram
+      for (a = b; a < window * 2 + 1 - b; a++) if (a != window) {
+        c = sentence_position - window + a;
+        if (c < 0) continue;
+        if (c >= sentence_length) continue;
+        last_word = sen[c];
+        if (last_word == -1) continue;
+        //modification begin
+        // the input of a pair is the context word composed with its morphemes, as in CBOW
+        STRATEGY(ComposeWord)(last_word, neu1, comp, morph_choice);
+        //modification end
+
+        for (c = 0; c < dim; c++) neu1e[c] = 0;
+
+        // HIERARCHICAL SOFTMAX
+        if (hs) TrainHierarchical(neu1, neu1e, word, hs_rows, hs_g);
+        // NEGATIVE SAMPLING
+        if (negative > 0) TrainNegatives(neu1, neu1e, word, &ring, &next_random, neg_targets, neg_rows, neg_g);
+        // Learn weights input -> hidden
+        STRATEGY(UpdateWord)(last_word, neu1e, morph_choice);
+      }
+    }
+    sentence_position++;
+    if (sentence_position >= sentence_length) {
+      if (batch > 1) STRATEGY(FlushBatch)(&bt, sen, sentence_length, &next_random);
+      sentence_length = 0;
+      continue;
+    }
+  }
+  CloseWordReader(wr);
+  free(neu1);
+  free(neu1e);
+  free(neg_targets);
+  free(neg_rows);
+  free(neg_g);
+  free(ring.target);
+  free(hs_rows);
+  free(hs_g);
+  if (batch > 1) FreeBatch(&bt);
+  free(morph_choice);
+  pthread_exit(NULL);
+}
@@ -0,0 +1,2180 @@
+//  Copyright 2013 Google Inc. All Rights Reserved.
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#define _GNU_SOURCE // pthread_setaffinity_np
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
+#include "lmm-kernel.h"
+#include "lmm-reader.h"
+
+#define EXP_TABLE_SIZE 1000
+#define MAX_EXP 6
+#define MAX_SENTENCE_LENGTH 1000
+#define MAX_CODE_LENGTH 40
+#define HASH_PREFIX 8
+#define ARENA_BLOCK_SIZE 1048576
+#define MAX_SCATTER 64
+
+//modification begin
+#define MAX_MAP_STRING 300
+#define MAX_MORPHEME_SIZE 100
+// Morpheme strategies (-model). A averages all morphemes of a word, S weights them by their cosine
+// similarity to the word and M takes the most similar prefix, root and suffix
+#define MODEL_A 0
+#define MODEL_S 1
+#define MODEL_M 2
+#ifndef LMM_MODEL
+#define LMM_MODEL MODEL_A // lmm-a, lmm-s and lmm-m are this file built with another default
+#endif
+//modification end
+
+//modification begin
+struct pos{
+  long long position;
+};
+
+struct word_map{
+  char *word;
+  int pn, rn, sn;
+  struct pos *prefix;
+  struct pos *root;
+  struct pos *suffix;
+};
+//modification end
+
+struct vocab_word {
+  long long cn; // word count
+  char *word;
+};
+
+// Block of a bump allocator, followed by its data
+struct arena_block {
+  struct arena_block *next;
+  long long used, size;
+};
+
+// Bump allocator for the many small objects of the vocabulary and the word map. Nothing is
+// freed on its own; ResetArena and FreeArena release whole blocks at once
+struct arena {
+  struct arena_block *head;
+};
+
+// Slot of an open-addressing string table. The cached hash and the first bytes of the word let
+// almost every probe finish inside the table without touching the word string itself
+struct hash_slot {
+  unsigned int hash;
+  int index; // position of the word in vocab / wordMap, -1 for an empty slot
+  char prefix[HASH_PREFIX];
+};
+
+// String table for vocab and wordMap; size is 2^(32 - shift) and grows to keep it at most half full
+struct hash_table {
+  struct hash_slot *slot;
+  long long size, used;
+  int shift;
+};
+
+// Word counts collected by one thread of the vocabulary pass, in order of first occurrence
+struct vocab_shard {
+  struct vocab_word *vocab;
+  struct hash_table table;
+  struct arena arena; // the shard's word strings
+  long long size, max_size, words;
+  int min_reduce;     // the shard's own ReduceVocab threshold under -max-vocab
+};
+
+// Header of the pre-tokenized corpus file written next to the training file. The header is followed
+// by the word ids and then the vocabulary, as (count, word with its terminating 0) pairs
+struct corpus_cache_header {
+  char magic[8];
+  long long vocab_size, min_count, max_vocab, vocab_checksum; // the vocabulary the corpus was encoded with
+  long long vocab_counted;                         // 1 if that vocabulary was counted from the training file
+  long long file_size, file_mtime;                 // the training file it was encoded from
+  long long words, vocab_bytes;
+};
+
+char train_file[MAX_STRING], output_file[MAX_STRING];
+char save_vocab_file[MAX_STRING], read_vocab_file[MAX_STRING];
+//modification begin
+char wordmap_file[MAX_STRING];
+long long map_size = 0;
+struct word_map *wordMap;
+struct arena map_arena, scratch_arena; // wordMap words and morpheme lists; strings split while parsing a line
+// Morphemes of every vocabulary word in compressed sparse row form: the prefixes of word w are
+// morph_index[morph_offset[3 * w] .. morph_offset[3 * w + 1]), followed by its roots up to
+// morph_offset[3 * w + 2] and its suffixes up to morph_offset[3 * w + 3]
+int *morph_offset, *morph_index;
+real *morph_weight; // similarity of each word-morpheme pair, parallel to morph_index; only written by the -weight-refresh sweeps
+long long weight_refresh = 0; // words between sweeps over morph_weight; 0 computes the weights on every occurrence
+// With -compose-refresh (model A), composed holds the mean of the morpheme vectors of every word that has morphemes
+real *composed;
+long long compose_refresh = 0; // words between sweeps over composed; 0 sums the morpheme vectors on every occurrence
+int model = LMM_MODEL;
+struct hash_table map_table;
+//modification end
+struct vocab_word *vocab;
+struct arena vocab_arena; // vocabulary words, Huffman codes and points
+// Training reads only these per-word arrays, never the vocab structs. The Huffman path of word w
+// is code_bits / code_points[code_offset[w] .. code_offset[w + 1])
+// Subsampling keeps an occurrence of word w iff the low 16 bits of next_random are <= vocab_keep[w]
+unsigned short *vocab_keep;
+long long *code_offset;
+char *code_bits;
+int *code_points;
+int binary = 0, cbow = 1, debug_mode = 2, window = 5, min_count = 5, num_threads = 12, min_reduce = 1;
+struct hash_table vocab_table;
+long long vocab_max_size = 1000, vocab_size = 0, max_vocab_size = 0, dim = 100;
+long long train_words = 0, word_count_actual = 0, iter = 5, file_size = 0, classes = 0;
+int corpus_cache = 0, mmap_input = 0;
+int bind_threads = 0; // 1 pins thread i to the i-th allowed CPU, 2 spreads the threads over them
+int *bind_cpus, bind_cpu_count = 0; // CPUs the process may run on, in ascending order
+char *train_map; // the training file mapped into memory for -mmap
+long long train_map_size = 0;
+int *corpus_ids; // vocabulary indices of the whole training file, </s> (0) marks the end of a line
+long long corpus_words = 0;
+struct vocab_shard *vocab_shards;
+long long vocab_words_read = 0; // progress of the vocabulary pass, summed over threads
+real alpha = 0.025, starting_alpha, sample = 1e-3;
+real *syn0, *syn1, *syn1neg, *expTable; //syn0: word vector; syn1: parameter vector; syn1neg: parameter vector for negative sampling
+clock_t start;
+
+int hs = 0, negative = 5, batch = 0;
+real ns_power = 0.75; // smoothing power of the negative sampling distribution
+long long ns_buffer = 0; // negatives drawn ahead per thread; 0 draws them when they are used
+int fast_sigmoid = 0; // KernelSigmoid instead of expTable
+
+// Negative sampling distribution, cn^ns_power / sum over the vocabulary, as a Walker / Vose alias
+// table: a draw picks a column uniformly and keeps it with probability prob, else takes alias
+struct alias_slot {
+  double prob;
+  int alias;
+};
+struct alias_slot *alias_table;
+double alias_scale; // vocab_size / 2^48, maps the 48 high bits of next_random to a column
+
+// Computes the unnormalized weights of the words of one thread's slice of the vocabulary
+void *UnigramWeightsThread(void *id) {
+  long long a, first = vocab_size * (long long)id / num_threads, last = vocab_size * ((long long)id + 1) / num_threads;
+  for (a = first; a < last; a++) alias_table[a].prob = pow(vocab[a].cn, ns_power);
+  pthread_exit(NULL);
+}
+
+void InitUnigramTable() { // init the negative sampling alias table in terms of the frequencies of words
+  long long a, small = 0, large = vocab_size, s, l;
+  double train_words_pow = 0;
+  int *work = (int *)malloc(vocab_size * sizeof(int));
+  pthread_t *pt = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+  alias_table = (struct alias_slot *)malloc(vocab_size * sizeof(struct alias_slot));
+  if (alias_table == NULL || work == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  for (a = 0; a < num_threads; a++) pthread_create(&pt[a], NULL, UnigramWeightsThread, (void *)a);
+  for (a = 0; a < num_threads; a++) pthread_join(pt[a], NULL);
+  for (a = 0; a < vocab_size; a++) train_words_pow += alias_table[a].prob; // total count of all words, in a fixed order
+  // Columns below the mean weight fill up from those above it; work keeps the small ones at the
+  // front and the large ones at the back
+  for (a = 0; a < vocab_size; a++) {
+    alias_table[a].prob *= vocab_size / train_words_pow;
+    alias_table[a].alias = a;
+    if (alias_table[a].prob < 1) work[small++] = a; else work[--large] = a;
+  }
+  while (small > 0 && large < vocab_size) {
+    s = work[--small];
+    l = work[large];
+    alias_table[s].alias = l;
+    alias_table[l].prob -= 1 - alias_table[s].prob;
+    if (alias_table[l].prob < 1) {
+      large++;
+      work[small++] = l;
+    }
+  }
+  // Whatever is left is 1 up to rounding
+  while (small > 0) alias_table[work[--small]].prob = 1;
+  for (a = large; a < vocab_size; a++) alias_table[work[a]].prob = 1;
+  alias_scale = vocab_size / 281474976710656.0;
+  free(work);
+  free(pt);
+}
+
+// Draws a negative sample; the column comes from the integer part of the scaled high bits of
+// next_random and the coin from the fraction, so one step of the generator is enough
+long long SampleUnigram(unsigned long long next_random) {
+  double u = (next_random >> 16) * alias_scale;
+  long long a = (long long)u;
+  if (a >= vocab_size) a = vocab_size - 1;
+  return u - a < alias_table[a].prob ? a : alias_table[a].alias;
+}
+
+// Negatives drawn ahead of use (-ns-buffer), so the syn1neg rows of the next training step can be
+// prefetched while the current one runs
+struct neg_ring {
+  long long *target;
+  long long size, pos;
+};
+
+// Moves the unused draws to the front and fills the rest of the ring
+void RefillNegatives(struct neg_ring *r, unsigned long long *next_random) {
+  long long a, left = r->size - r->pos;
+  memmove(r->target, r->target + r->pos, left * sizeof(long long));
+  for (a = left; a < r->size; a++) {
+    *next_random = *next_random * (unsigned long long)25214903917 + 11;
+    r->target[a] = SampleUnigram(*next_random);
+    if (r->target[a] == 0) r->target[a] = *next_random % (vocab_size - 1) + 1;
+  }
+  r->pos = 0;
+}
+
+long long NextNegative(struct neg_ring *r, unsigned long long *next_random) {
+  long long target;
+  if (r->size == 0) {
+    *next_random = *next_random * (unsigned long long)25214903917 + 11;
+    target = SampleUnigram(*next_random);
+    if (target == 0) target = *next_random % (vocab_size - 1) + 1;
+    return target;
+  }
+  if (r->pos == r->size) RefillNegatives(r, next_random);
+  return r->target[r->pos++];
+}
+
+// Prefetches the syn1neg rows of the negatives that the step after the current one will draw
+void PrefetchNegatives(struct neg_ring *r, unsigned long long *next_random) {
+  long long a, b;
+  if (r->size - r->pos < 2 * negative) RefillNegatives(r, next_random);
+  for (a = r->pos + negative; a < r->pos + 2 * negative; a++)
+    for (b = 0; b < dim; b += 64 / sizeof(real)) __builtin_prefetch(syn1neg + r->target[a] * dim + b, 1);
+}
+
+// Prints the largest relative error of the alias table against the exact distribution and the
+// sampling throughput (-debug 3)
+void ReportSamplerStats() {
+  long long a, draws = 20000000, hits = 0;
+  unsigned long long next_random = 1;
+  double train_words_pow = 0, exact, error, max_error = 0, *q = (double *)calloc(vocab_size, sizeof(double));
+  struct timespec t0, t1;
+  real seconds;
+  for (a = 0; a < vocab_size; a++) {
+    q[a] += alias_table[a].prob;
+    q[alias_table[a].alias] += 1 - alias_table[a].prob;
+    train_words_pow += pow(vocab[a].cn, ns_power);
+  }
+  for (a = 0; a < vocab_size; a++) {
+    exact = pow(vocab[a].cn, ns_power) / train_words_pow;
+    error = fabs(q[a] / vocab_size - exact) / exact;
+    if (error > max_error) max_error = error;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (a = 0; a < draws; a++) {
+    next_random = next_random * (unsigned long long)25214903917 + 11;
+    hits += SampleUnigram(next_random) == 0;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  printf("Negative sampler: %lld words, %.1f KB, largest relative error %.2e\n",
+   vocab_size, vocab_size * sizeof(struct alias_slot) / 1024.0, max_error);
+  printf("Negative sampler draws: %.2fM/sec (%lld of %lld were </s>)\n", draws / (seconds + 1e-9) / 1000000, hits, draws);
+  free(q);
+}
+
+void *ArenaAlloc(struct arena *ar, long long size) {
+  struct arena_block *block = ar->head;
+  long long block_size;
+  char *ptr;
+  size = (size + 7) & ~7LL; // keep every allocation 8-byte aligned
+  if (block == NULL || block->used + size > block->size) {
+    block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+    block = (struct arena_block *)malloc(sizeof(struct arena_block) + block_size);
+    if (block == NULL) {printf("Memory allocation failed\n"); exit(1);}
+    block->next = ar->head;
+    block->used = 0;
+    block->size = block_size;
+    ar->head = block;
+  }
+  ptr = (char *)(block + 1) + block->used;
+  block->used += size;
+  return ptr;
+}
+
+// Copies the first n bytes of str into the arena as a terminated string
+char *ArenaStrndup(struct arena *ar, char *str, long long n) {
+  char *dst = (char *)ArenaAlloc(ar, n + 1);
+  memcpy(dst, str, n);
+  dst[n] = 0;
+  return dst;
+}
+
+// Releases all allocations but keeps one block for reuse
+void ResetArena(struct arena *ar) {
+  struct arena_block *block;
+  if (ar->head == NULL) return;
+  while (ar->head->next != NULL) {
+    block = ar->head->next;
+    ar->head->next = block->next;
+    free(block);
+  }
+  ar->head->used = 0;
+}
+
+void FreeArena(struct arena *ar) {
+  struct arena_block *block;
+  while (ar->head != NULL) {
+    block = ar->head;
+    ar->head = block->next;
+    free(block);
+  }
+}
+
+// Maps the training file read-only; the pages are read once front to back per pass
+void MapTrainFile() {
+  struct stat st;
+  int fd;
+  if (train_map != NULL) return;
+  fd = open(train_file, O_RDONLY);
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    printf("ERROR: training data file not found!\n");
+    exit(1);
+  }
+  train_map_size = st.st_size;
+  train_map = (char *)mmap(NULL, train_map_size > 0 ? train_map_size : 1, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (train_map == MAP_FAILED) {
+    printf("ERROR: cannot map training file %s\n", train_file);
+    exit(1);
+  }
+  madvise(train_map, train_map_size, MADV_SEQUENTIAL);
+}
+
+void UnmapTrainFile() {
+  munmap(train_map, train_map_size > 0 ? train_map_size : 1);
+  train_map = NULL;
+  train_map_size = 0;
+}
+
+// Byte range of the mapped training file owned by thread 'id'. Ranges start right after a
+// line break, so every line is read by exactly one thread and no word is split. A file smaller than
+// num_threads bytes leaves the first threads with empty ranges
+void LineRange(long long id, long long *begin, long long *end) {
+  *begin = train_map_size / num_threads * id;
+  *end = id == num_threads - 1 ? train_map_size : train_map_size / num_threads * (id + 1);
+  while (*begin > 0 && *begin < train_map_size && train_map[*begin - 1] != '\n') (*begin)++;
+  while (*end > 0 && *end < train_map_size && train_map[*end - 1] != '\n') (*end)++;
+}
+
+// Reader that tokenizes thread 'id''s line range of the mapped training file in place
+struct word_reader *OpenMappedReader(long long id) {
+  long long begin, end;
+  struct word_reader *wr = (struct word_reader *)calloc(1, sizeof(struct word_reader));
+  LineRange(id, &begin, &end);
+  wr->buf = train_map + begin;
+  wr->len = end - begin;
+  return wr;
+}
+
+// Returns hash value of a word. The word is consumed 8 bytes at a time, each block mixed in with a
+// 64-bit multiply, and the length is folded into the seed
+unsigned int GetWordHash(char *word) {
+  unsigned long long a, length = strlen(word), hash = 0x9E3779B97F4A7C15ULL ^ length, block;
+  while (length >= 8) {
+    memcpy(&block, word, 8);
+    hash = (hash ^ block) * 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 32;
+    word += 8;
+    length -= 8;
+  }
+  block = 0;
+  for (a = 0; a < length; a++) block |= (unsigned long long)(unsigned char)word[a] << (a * 8);
+  hash = (hash ^ block) * 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 32;
+  return (unsigned int)hash;
+}
+
+// Allocates an empty table with room for at least n words
+void InitHashTable(struct hash_table *t, long long n) {
+  long long a;
+  t->size = 1024;
+  t->shift = 22;
+  while (t->size < n * 2) {
+    t->size *= 2;
+    t->shift--;
+  }
+  t->used = 0;
+  t->slot = (struct hash_slot *)malloc(t->size * sizeof(struct hash_slot));
+  for (a = 0; a < t->size; a++) t->slot[a].index = -1;
+}
+
+// Drops all entries and resizes the table for n words
+void ResetHashTable(struct hash_table *t, long long n) {
+  free(t->slot);
+  InitHashTable(t, n);
+}
+
+// First slot to probe: the top bits of the hash
+long long HashSlot(struct hash_table *t, unsigned int hash) {
+  return hash >> t->shift;
+}
+
+// Compares a slot with a word without touching the stored string: returns 0 for a different word,
+// 1 for the same word, and 2 if hash and prefix match but the strings have to be compared
+int SlotMatch(struct hash_slot *s, char *word, unsigned int hash) {
+  if (s->hash != hash || strncmp(s->prefix, word, HASH_PREFIX)) return 0;
+  return memchr(s->prefix, 0, HASH_PREFIX) != NULL ? 1 : 2;
+}
+
+// Doubles the table; slots are moved by their cached hash, so no word is rehashed
+void GrowHashTable(struct hash_table *t) {
+  long long a, b, old_size = t->size;
+  struct hash_slot *old = t->slot;
+  t->size *= 2;
+  t->shift--;
+  t->slot = (struct hash_slot *)malloc(t->size * sizeof(struct hash_slot));
+  for (a = 0; a < t->size; a++) t->slot[a].index = -1;
+  for (a = 0; a < old_size; a++) if (old[a].index != -1) {
+    b = HashSlot(t, old[a].hash);
+    while (t->slot[b].index != -1) b = (b + 1) & (t->size - 1);
+    t->slot[b] = old[a];
+  }
+  free(old);
+}
+
+// Adds a word that is not in the table yet
+void HashInsert(struct hash_table *t, char *word, unsigned int hash, int index) {
+  long long a, length = strlen(word);
+  if ((t->used + 1) * 2 > t->size) GrowHashTable(t);
+  a = HashSlot(t, hash);
+  while (t->slot[a].index != -1) a = (a + 1) & (t->size - 1);
+  t->slot[a].hash = hash;
+  t->slot[a].index = index;
+  memset(t->slot[a].prefix, 0, HASH_PREFIX); // not terminated when the word is HASH_PREFIX bytes or longer
+  memcpy(t->slot[a].prefix, word, length < HASH_PREFIX ? length : HASH_PREFIX);
+  t->used++;
+}
+
+// Returns position of a word in the vocabulary; if the word is not found, returns -1
+int SearchVocab(char *word) {
+  unsigned int hash = GetWordHash(word);
+  long long a = HashSlot(&vocab_table, hash);
+  struct hash_slot *s;
+  int m;
+  while ((s = &vocab_table.slot[a])->index != -1) {
+    m = SlotMatch(s, word, hash);
+    if (m == 1 || (m == 2 && !strcmp(word, vocab[s->index].word))) return s->index; //find and return the word
+    a = (a + 1) & (vocab_table.size - 1); // continue searching, forward direction
+  }
+  return -1;
+}
+
+// Reads a word and returns its index in the vocabulary
+int ReadWordIndex(struct word_reader *wr) {
+  char word[MAX_STRING];
+  if (wr->ids != NULL) {
+    if (wr->pos >= wr->len) {
+      wr->eof = 1;
+      return -1;
+    }
+    return wr->ids[wr->pos++];
+  }
+  ReadWord(word, wr);
+  if (wr->eof) return -1;
+  return SearchVocab(word);
+}
+
+// Adds a word to the vocabulary
+int AddWordToVocab(char *word) {
+  unsigned int length = strlen(word);
+
+  if (length > MAX_STRING - 1) length = MAX_STRING - 1;
+  vocab[vocab_size].word = ArenaStrndup(&vocab_arena, word, length);
+  vocab[vocab_size].cn = 0;
+
+  vocab_size++;
+  // Reallocate memory if needed
+  if (vocab_size + 2 >= vocab_max_size) {
+    vocab_max_size += 1000;
+    vocab = (struct vocab_word *)realloc(vocab, vocab_max_size * sizeof(struct vocab_word));
+  }
+  HashInsert(&vocab_table, word, GetWordHash(word), vocab_size - 1);
+  return vocab_size - 1;
+}
+
+
+// Prints the probe-length distribution of the vocabulary table and the lookup throughput
+// measured by searching every vocabulary word (-debug 3)
+void ReportHashStats() {
+  long long a, b, probes, lookups = 0, max_probes = 0, total_probes = 0, found = 0;
+  long long histogram[6] = {0}; // 1, 2, 3, 4, 5-8, >8 probes
+  struct timespec t0, t1;
+  real seconds;
+  for (a = 0; a < vocab_table.size; a++) if (vocab_table.slot[a].index != -1) {
+    probes = ((a - HashSlot(&vocab_table, vocab_table.slot[a].hash)) & (vocab_table.size - 1)) + 1;
+    total_probes += probes;
+    if (probes > max_probes) max_probes = probes;
+    histogram[probes <= 4 ? probes - 1 : (probes <= 8 ? 4 : 5)]++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (b = 0; lookups < 10000000; b++) for (a = 0; a < vocab_size; a++, lookups++) found += SearchVocab(vocab[a].word) == a;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  printf("Vocab hash: %lld words in %lld slots, %.3f probes on average, %lld at most\n",
+   vocab_table.used, vocab_table.size, total_probes / (real)(vocab_table.used + 1e-9), max_probes);
+  printf("Vocab hash probes: 1: %lld  2: %lld  3: %lld  4: %lld  5-8: %lld  >8: %lld\n",
+   histogram[0], histogram[1], histogram[2], histogram[3], histogram[4], histogram[5]);
+  printf("Vocab hash lookups: %.2fM/sec (%lld of %lld found)\n", lookups / (seconds + 1e-9) / 1000000, found, lookups);
+}
+
+// Used later for sorting by word counts
+int VocabCompare(const void *a, const void *b) {
+    return ((struct vocab_word *)b)->cn - ((struct vocab_word *)a)->cn;
+}
+
+// Sorts the vocabulary by frequency using word counts
+void SortVocab() {
+  int a, size;
+  struct arena sorted = {NULL};
+  // Sort the vocabulary and keep </s> at the first position
+  qsort(&vocab[1], vocab_size - 1, sizeof(struct vocab_word), VocabCompare);
+  size = vocab_size;
+  for (a = 1; a < size; a++) if (vocab[a].cn < min_count) break;
+  ResetHashTable(&vocab_table, a); // the kept words are a prefix of the sorted vocabulary
+  train_words = 0;
+  for (a = 0; a < size; a++) {
+    // Words occuring less than min_count times will be discarded from the vocab
+    if ((vocab[a].cn < min_count) && (a != 0)) {
+      vocab_size--;
+    } else {
+      // The kept words are copied to a fresh arena in frequency order, the discarded ones are released with the old arena
+      vocab[a].word = ArenaStrndup(&sorted, vocab[a].word, strlen(vocab[a].word));
+      // Hash will be re-computed, as after the sorting it is not actual
+      HashInsert(&vocab_table, vocab[a].word, GetWordHash(vocab[a].word), a);
+      train_words += vocab[a].cn;
+    }
+  }
+  FreeArena(&vocab_arena);
+  vocab_arena = sorted;
+  vocab = (struct vocab_word *)realloc(vocab, (vocab_size + 1) * sizeof(struct vocab_word));
+}
+
+// Reduces the vocabulary by removing infrequent tokens
+void ReduceVocab() {
+  int a, b = 0;
+  struct arena kept = {NULL};
+  for (a = 0; a < vocab_size; a++) if (vocab[a].cn > min_reduce) {
+    vocab[b].cn = vocab[a].cn;
+    vocab[b].word = ArenaStrndup(&kept, vocab[a].word, strlen(vocab[a].word));
+    b++;
+  }
+  FreeArena(&vocab_arena);
+  vocab_arena = kept;
+  vocab_size = b;
+  ResetHashTable(&vocab_table, vocab_size);
+  for (a = 0; a < vocab_size; a++) {
+    // Hash will be re-computed, as it is not actual
+    HashInsert(&vocab_table, vocab[a].word, GetWordHash(vocab[a].word), a);
+  }
+  fflush(stdout);
+  min_reduce++;
+}
+
+int *tree_parent; // parent of every node of the Huffman tree while the codes are filled
+char *tree_binary;
+
+// Writes the packed codes of one thread's slice of the vocabulary. Each word walks from its leaf to
+// the root and fills its own range backwards, so the slices never overlap
+void *FillCodesThread(void *id) {
+  long long a, b, d, root = vocab_size * 2 - 2;
+  long long first = vocab_size * (long long)id / num_threads, last = vocab_size * ((long long)id + 1) / num_threads;
+  for (a = first; a < last; a++) {
+    d = code_offset[a + 1];
+    b = a;
+    while (b != root) { // a vocabulary of one word is its own root, with a code of length 0
+      d--;
+      code_bits[d] = tree_binary[b];
+      b = tree_parent[b];
+      code_points[d] = b - vocab_size; // the path starts at the root; the leaf itself is not stored
+    }
+  }
+  pthread_exit(NULL);
+}
+
+// Create binary Huffman tree using the word counts
+// Frequent words will have short uniqe binary codes
+void CreateBinaryTree() {
+  long long a, min1i, min2i, pos1, pos2, root = vocab_size * 2 - 2, max_length = 0;
+  long long *count = (long long *)calloc(vocab_size * 2 + 1, sizeof(long long));
+  pthread_t *pt = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+  tree_binary = (char *)calloc(vocab_size * 2 + 1, sizeof(char));
+  tree_parent = (int *)calloc(vocab_size * 2 + 1, sizeof(int));
+  if (count == NULL || tree_binary == NULL || tree_parent == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  for (a = 0; a < vocab_size; a++) count[a] = vocab[a].cn;
+  for (a = vocab_size; a < vocab_size * 2; a++) count[a] = 1e15;
+  pos1 = vocab_size - 1;
+  pos2 = vocab_size;
+  // Following algorithm constructs the Huffman tree by adding one node at a time
+  for (a = 0; a < vocab_size - 1; a++) {
+    // First, find two smallest nodes 'min1, min2'
+    if (pos1 >= 0 && count[pos1] < count[pos2]) min1i = pos1--;
+    else min1i = pos2++;
+    if (pos1 >= 0 && count[pos1] < count[pos2]) min2i = pos1--;
+    else min2i = pos2++;
+    count[vocab_size + a] = count[min1i] + count[min2i];
+    tree_parent[min1i] = vocab_size + a;
+    tree_parent[min2i] = vocab_size + a;
+    tree_binary[min2i] = 1;
+  }
+  // Every parent is created after its children, so one pass from the root down gives all depths;
+  // count is reused for them
+  count[root] = 0;
+  for (a = root - 1; a >= 0; a--) count[a] = count[tree_parent[a]] + 1;
+  // The codes of all words are packed into code_bits and their inner nodes into code_points
+  code_offset = (long long *)malloc((vocab_size + 1) * sizeof(long long));
+  if (code_offset == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  code_offset[0] = 0;
+  for (a = 0; a < vocab_size; a++) {
+    code_offset[a + 1] = code_offset[a] + count[a];
+    if (count[a] > max_length) max_length = count[a];
+  }
+  if (max_length > MAX_CODE_LENGTH) {printf("Huffman code of length %lld is longer than %d\n", max_length, MAX_CODE_LENGTH); exit(1);}
+  code_bits = (char *)ArenaAlloc(&vocab_arena, code_offset[vocab_size]);
+  code_points = (int *)ArenaAlloc(&vocab_arena, code_offset[vocab_size] * sizeof(int));
+  // Now assign binary code to each vocabulary word
+  for (a = 0; a < num_threads; a++) pthread_create(&pt[a], NULL, FillCodesThread, (void *)a);
+  for (a = 0; a < num_threads; a++) pthread_join(pt[a], NULL);
+  free(count);
+  free(tree_binary);
+  free(tree_parent);
+  free(pt);
+}
+
+//modification begin
+int SearchMap(char *word) {
+  unsigned int hash = GetWordHash(word);
+  long long a = HashSlot(&map_table, hash);
+  struct hash_slot *s;
+  int m;
+  while ((s = &map_table.slot[a])->index != -1) {
+    m = SlotMatch(s, word, hash);
+    if (m == 1 || (m == 2 && !strcmp(word, wordMap[s->index].word))) return s->index; //find and return the word position in wordMap
+    a = (a + 1) & (map_table.size - 1); // continue searching, forward direction
+  }
+  return -1;
+}
+
+char* StrReplace(char *str, const char *oldStr, const char *newStr){
+  char *ptr = NULL;
+  while(ptr = strstr(str, oldStr))
+  {
+    memmove(ptr + strlen(newStr), ptr + strlen(oldStr), strlen(ptr) - strlen(oldStr) + 1);
+    memcpy(ptr, &newStr[0], strlen(newStr));
+  }
+  return str;
+}
+
+char** SplitStr(char *str, char spliter, int *cnt, struct arena *ar)
+{
+  char ** dst = NULL;
+  char *ptr1, *ptr2;
+  int idx;
+  *cnt = 0;
+  
+  ptr2 = str;
+  ptr1 = strchr(ptr2, spliter);
+
+  while (1)
+  {
+    if(ptr1 == NULL){
+      if(strlen(ptr2) <= 0)
+        break;
+      else{
+        *cnt += 1; break;
+      }
+    }
+    if(ptr1 != ptr2)
+    {
+      *cnt += 1;
+    }
+    ptr2 = ptr1 + 1;
+    ptr1 = strchr(ptr2, spliter);
+  }
+
+  dst = (char**) ArenaAlloc(ar, *cnt * sizeof(char*));
+
+  idx = 0;
+  ptr2 = str;
+  ptr1 = strchr(ptr2, spliter);
+  while (1)
+  {
+    if(ptr1 == NULL){
+      if(strlen(ptr2) <= 0)
+        break;
+      else{
+        dst[idx] = ArenaStrndup(ar, ptr2, strlen(ptr2));
+        break;
+      }
+    }
+    if(ptr1 != ptr2)
+    {
+      dst[idx] = ArenaStrndup(ar, ptr2, ptr1 - ptr2);
+      idx++;
+    }
+    ptr2 = ptr1 + 1;
+    ptr1 = strchr(ptr2, spliter);
+  }
+  
+  return dst;
+}
+
+char* GetMainWordOfPhrase(char *str, char spliter, struct arena *ar){
+  int idx, maxIdx;
+  int len;
+  int cnt;
+  char ** tmp = SplitStr(str, spliter, &cnt, ar);
+  if(cnt == 0) return NULL;
+  maxIdx = 0;
+  len = strlen(tmp[0]);
+  for(idx = 0; idx < cnt; idx++){
+    if(len <= strlen(tmp[idx])){
+      maxIdx = idx;
+      len = strlen(tmp[maxIdx]);
+    }
+  }
+  return tmp[maxIdx];
+}
+
+// Parses one comma separated morpheme field of a wordmap line into an array of vocab positions;
+// returns the number of morphemes found in the vocabulary
+int LoadMorphemes(char *field, struct pos **morphemes){
+  char **subPtr;
+  int wordCnt, effCnt, idx;
+  char spliter2 = ',';
+  char spliter3 = ' ';
+
+  *morphemes = NULL;
+  if(0 == strcmp(field, " ")) return 0;
+  subPtr = SplitStr(field, spliter2, &wordCnt, &scratch_arena);
+  if(wordCnt <= 0) return 0;
+  *morphemes = (struct pos*)ArenaAlloc(&map_arena, wordCnt * sizeof(struct pos));
+  effCnt = 0;
+  for(idx = 0; idx < wordCnt; idx++)
+  {
+    char *tmpMainWord = GetMainWordOfPhrase(subPtr[idx], spliter3, &scratch_arena);
+    long long morphemeWord = tmpMainWord == NULL ? -1 : SearchVocab(tmpMainWord);
+    if(morphemeWord != -1 && morphemeWord != 0){
+      (*morphemes)[effCnt].position = morphemeWord;
+      effCnt++;
+    }
+  }
+  return effCnt;
+}
+
+void LoadMapData(){
+  long long vIdx, curIdx;
+  long long idx, total;
+  int *mapIdx;
+  //int strLen;
+  char str[MAX_MAP_STRING];
+
+  char spliter = '#';
+
+  FILE *fmap;
+
+  fmap = fopen(wordmap_file, "rb");
+  if (fmap == NULL) {
+    printf("ERROR: wordmap file not found!\n");
+    exit(1);
+  }
+
+  fseek(fmap, 0, SEEK_SET);
+  map_size = 0;
+  while(1){
+    if(NULL == fgets(str, MAX_MAP_STRING, fmap)) break;
+    char *ptr;
+    ptr = strchr(str, spliter);
+    if(ptr - str + 1 <= 1)continue;//remove useless lines
+	  map_size++;
+  }
+
+  wordMap = (struct word_map*)malloc(map_size * sizeof(struct word_map));
+  for(idx = 0; idx < map_size; idx++){
+    wordMap[idx].word = NULL;
+    wordMap[idx].pn = 0;
+    wordMap[idx].rn = 0;
+    wordMap[idx].sn = 0;
+    wordMap[idx].prefix = NULL;
+    wordMap[idx].root= NULL;
+    wordMap[idx].suffix = NULL;
+  }
+
+  InitHashTable(&map_table, map_size); ////sized for every line of the wordmap file
+
+  fseek(fmap, 0, SEEK_SET); ////set the pointer back to the start of wordmap file
+  map_size = 0;
+  while(1){
+    ResetArena(&scratch_arena); ////the split strings of a line live until the next line is read
+    if(NULL == fgets(str, MAX_MAP_STRING, fmap)) break;
+    StrReplace(str, "\r\n","");
+    //printf("[Debug] str = %s\n", str);
+    char **mPtr = NULL;
+    int mCnt;
+    mPtr = SplitStr(str, spliter, &mCnt, &scratch_arena);
+    //printf("[Debug] mCnt = %d\n", mCnt);
+    if(mCnt < 4) continue;
+    
+    curIdx = SearchMap(mPtr[0]);
+    if(curIdx != -1) continue; // if the word exists in wordMap, then continue
+
+    curIdx = SearchVocab(mPtr[0]);
+    if(curIdx == -1 || curIdx == 0) continue; // if the word doesn't exist in vocab, then continue
+
+    wordMap[map_size].word = ArenaStrndup(&map_arena, mPtr[0], strlen(mPtr[0])); //store the target word
+
+    wordMap[map_size].pn = LoadMorphemes(mPtr[1], &wordMap[map_size].prefix); //prefix
+    wordMap[map_size].rn = LoadMorphemes(mPtr[2], &wordMap[map_size].root); //root
+    wordMap[map_size].sn = LoadMorphemes(mPtr[3], &wordMap[map_size].suffix); //suffix
+
+    HashInsert(&map_table, wordMap[map_size].word, GetWordHash(wordMap[map_size].word), map_size);
+    map_size++;
+  }
+  FreeArena(&scratch_arena);
+
+  fclose(fmap);
+  /*printf("wordMap[%lld].word = %s\n", map_size - 1, wordMap[map_size - 1].word);
+
+  for(curIdx = 0; curIdx < wordMap[map_size - 1].pn; curIdx++) 
+    printf("wordMap[%lld].prefix[%d] = %s\n", map_size - 1, curIdx, wordMap[map_size - 1].prefix[curIdx]);
+
+  for(curIdx = 0; curIdx < wordMap[map_size - 1].rn; curIdx++) 
+    printf("wordMap[%lld].root[%d] = %s\n", map_size - 1, curIdx, wordMap[map_size - 1].root[curIdx]);
+
+  for(curIdx = 0; curIdx < wordMap[map_size - 1].sn; curIdx++) 
+    printf("wordMap[%lld].suffix[%d] = %s\n", map_size - 1, curIdx, wordMap[map_size - 1].suffix[curIdx]);
+  return;*/
+
+  printf("[Debug] map_size = %lld\n", map_size);
+  printf("[Debug] vocab_size = %lld\n", vocab_size);
+
+  // Flatten the morphemes of the vocabulary words into morph_offset / morph_index
+  mapIdx = (int *)malloc(vocab_size * sizeof(int));
+  morph_offset = (int *)malloc((3 * vocab_size + 1) * sizeof(int));
+  total = 0;
+  for(vIdx = 0; vIdx < vocab_size; vIdx++){
+    curIdx = vIdx == 0 ? -1 : SearchMap(vocab[vIdx].word);
+    if(curIdx == 0) curIdx = -1;
+    mapIdx[vIdx] = curIdx;
+    morph_offset[3 * vIdx] = total;
+    if(curIdx != -1) total += wordMap[curIdx].pn;
+    morph_offset[3 * vIdx + 1] = total;
+    if(curIdx != -1) total += wordMap[curIdx].rn;
+    morph_offset[3 * vIdx + 2] = total;
+    if(curIdx != -1) total += wordMap[curIdx].sn;
+
+    printf("[Debug] Loading %.2f%%%c", (float)vIdx / vocab_size * 100, 13);
+    fflush(stdout);
+  }
+  morph_offset[3 * vocab_size] = total;
+  morph_index = (int *)malloc((total + 1) * sizeof(int));
+  morph_weight = (real *)malloc((total + 1) * sizeof(real));
+  for(idx = 0; idx < total; idx++) morph_weight[idx] = 1;
+  for(vIdx = 0; vIdx < vocab_size; vIdx++){
+    curIdx = mapIdx[vIdx];
+    if(curIdx == -1) continue;
+    for(idx = 0; idx < wordMap[curIdx].pn; idx++) morph_index[morph_offset[3 * vIdx] + idx] = wordMap[curIdx].prefix[idx].position;
+    for(idx = 0; idx < wordMap[curIdx].rn; idx++) morph_index[morph_offset[3 * vIdx + 1] + idx] = wordMap[curIdx].root[idx].position;
+    for(idx = 0; idx < wordMap[curIdx].sn; idx++) morph_index[morph_offset[3 * vIdx + 2] + idx] = wordMap[curIdx].suffix[idx].position;
+  }
+  free(mapIdx);
+
+  // Training only needs the flattened lists
+  FreeArena(&map_arena);
+  free(wordMap);
+  wordMap = NULL;
+  free(map_table.slot);
+}
+//modification end
+
+// Counts one occurrence of a word in a thread's private vocabulary
+void ShardCountWord(struct vocab_shard *shard, char *word) {
+  unsigned int hash = GetWordHash(word);
+  long long a = HashSlot(&shard->table, hash);
+  struct hash_slot *s;
+  int m;
+  while ((s = &shard->table.slot[a])->index != -1) {
+    m = SlotMatch(s, word, hash);
+    if (m == 1 || (m == 2 && !strcmp(word, shard->vocab[s->index].word))) {
+      shard->vocab[s->index].cn++;
+      return;
+    }
+    a = (a + 1) & (shard->table.size - 1);
+  }
+  if (shard->size == shard->max_size) {
+    shard->max_size *= 2;
+    shard->vocab = (struct vocab_word *)realloc(shard->vocab, shard->max_size * sizeof(struct vocab_word));
+  }
+  shard->vocab[shard->size].word = ArenaStrndup(&shard->arena, word, strlen(word));
+  shard->vocab[shard->size].cn = 1;
+  HashInsert(&shard->table, word, hash, shard->size);
+  shard->size++;
+}
+
+// ReduceVocab for one counting shard: drops its words seen at most min_reduce times, keeping the
+// others in order of first occurrence
+void ReduceShard(struct vocab_shard *shard) {
+  long long a, b = 0;
+  struct arena kept = {NULL};
+  for (a = 0; a < shard->size; a++) if (shard->vocab[a].cn > shard->min_reduce) {
+    shard->vocab[b].cn = shard->vocab[a].cn;
+    shard->vocab[b].word = ArenaStrndup(&kept, shard->vocab[a].word, strlen(shard->vocab[a].word));
+    b++;
+  }
+  FreeArena(&shard->arena);
+  shard->arena = kept;
+  shard->size = b;
+  ResetHashTable(&shard->table, shard->size);
+  for (a = 0; a < shard->size; a++) HashInsert(&shard->table, shard->vocab[a].word, GetWordHash(shard->vocab[a].word), a);
+  shard->min_reduce++;
+}
+
+// Counts the words of one line range of the training file into a private shard. Under -max-vocab
+// each shard keeps at most max_vocab_size / num_threads words, so the bound holds while counting
+void *LearnVocabThread(void *id) {
+  long long progress, limit = max_vocab_size / num_threads > 0 ? max_vocab_size / num_threads : 1;
+  char word[MAX_STRING];
+  struct vocab_shard *shard = &vocab_shards[(long long)id];
+  struct word_reader *wr = OpenMappedReader((long long)id);
+  shard->max_size = 1024;
+  shard->size = 0;
+  shard->words = 0;
+  shard->min_reduce = 1;
+  shard->arena.head = NULL;
+  shard->vocab = (struct vocab_word *)malloc(shard->max_size * sizeof(struct vocab_word));
+  InitHashTable(&shard->table, shard->max_size);
+  while (1) {
+    ReadWord(word, wr);
+    if (wr->eof) break;
+    shard->words++;
+    if (shard->words % 100000 == 0) {
+      progress = __sync_add_and_fetch(&vocab_words_read, 100000); // shared by all counting threads
+      if ((debug_mode > 1) && (id == 0)) {
+        printf("%lldK%c", progress / 1000, 13);
+        fflush(stdout);
+      }
+    }
+    ShardCountWord(shard, word);
+    if (max_vocab_size > 0 && shard->size > limit) ReduceShard(shard);
+  }
+  CloseWordReader(wr);
+  pthread_exit(NULL);
+}
+
+// Counts the training file with num_threads threads over line-aligned byte ranges. The shards are
+// merged in file order, so words enter the vocabulary in order of first occurrence and the counts,
+// and therefore the order after SortVocab, are the same as a single pass over the file
+void LearnVocabFromTrainFile() {
+  long long a, i, t;
+  struct timespec vocab_start, vocab_end;
+  real seconds;
+  pthread_t *pt = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+  ResetHashTable(&vocab_table, 0);
+  MapTrainFile();
+
+  vocab_size = 0;
+  AddWordToVocab((char *)"</s>");
+  clock_gettime(CLOCK_MONOTONIC, &vocab_start);
+  vocab_shards = (struct vocab_shard *)malloc(num_threads * sizeof(struct vocab_shard));
+  vocab_words_read = 0;
+  for (t = 0; t < num_threads; t++) pthread_create(&pt[t], NULL, LearnVocabThread, (void *)t);
+  for (t = 0; t < num_threads; t++) pthread_join(pt[t], NULL);
+  for (t = 0; t < num_threads; t++) {
+    for (a = 0; a < vocab_shards[t].size; a++) {
+      i = SearchVocab(vocab_shards[t].vocab[a].word);
+      if (i == -1) i = AddWordToVocab(vocab_shards[t].vocab[a].word);
+      vocab[i].cn += vocab_shards[t].vocab[a].cn;
+      if (max_vocab_size > 0 && vocab_size > max_vocab_size) ReduceVocab(); //bound the memory use by reducing words whose frequencies are lower than min_reduce
+    }
+    train_words += vocab_shards[t].words;
+    free(vocab_shards[t].vocab);
+    free(vocab_shards[t].table.slot);
+    FreeArena(&vocab_shards[t].arena);
+  }
+  free(vocab_shards);
+  free(pt);
+  clock_gettime(CLOCK_MONOTONIC, &vocab_end);
+  if (debug_mode > 0) {
+    seconds = (vocab_end.tv_sec - vocab_start.tv_sec) + (vocab_end.tv_nsec - vocab_start.tv_nsec) / 1e9;
+    printf("Read %lld words in %.2fs (%.2fM words/sec)\n", train_words, seconds, train_words / (seconds + 1e-9) / 1000000);
+  }
+
+  SortVocab();
+  if (debug_mode > 0) {
+    printf("Vocab size: %lld\n", vocab_size);
+    printf("Words in train file: %lld\n", train_words);
+  }
+	//modification begin
+	printf("[Debug] Load word map ...\n");
+	LoadMapData();
+  printf("[Debug] Load word map successfully!\n");
+	//modification end
+  file_size = train_map_size;
+  if (!mmap_input) UnmapTrainFile();
+}
+
+void SaveVocab() {
+  long long i;
+  FILE *fo = fopen(save_vocab_file, "wb");
+  for (i = 0; i < vocab_size; i++) fprintf(fo, "%s %lld\n", vocab[i].word, vocab[i].cn);
+  fclose(fo);
+}
+
+void ReadVocab() {
+  long long a, i = 0;
+  char word[MAX_STRING];
+  FILE *fin;
+  struct word_reader *wr = OpenWordReader(read_vocab_file);
+  if (wr == NULL) {
+    printf("Vocabulary file not found\n");
+    exit(1);
+  }
+  ResetHashTable(&vocab_table, 0);
+  vocab_size = 0;
+  while (1) {
+    ReadWord(word, wr);
+    if (wr->eof) break;
+    a = AddWordToVocab(word);
+    ReadWord(word, wr);
+    vocab[a].cn = atoll(word);
+    ReadWord(word, wr); // consume the line break, returned as </s>
+    i++;
+  }
+  CloseWordReader(wr);
+  SortVocab();
+  if (debug_mode > 0) {
+    printf("Vocab size: %lld\n", vocab_size);
+    printf("Words in train file: %lld\n", train_words);
+  }
+  fin = fopen(train_file, "rb");
+  if (fin == NULL) {
+    printf("ERROR: training data file not found!\n");
+    exit(1);
+  }
+  fseek(fin, 0, SEEK_END);
+  file_size = ftell(fin);
+  fclose(fin);
+}
+
+// Fingerprint of the final vocabulary; the corpus cache is only valid for the vocabulary it was encoded with
+long long VocabChecksum() {
+  unsigned long long a, hash = 14695981039346656037ULL;
+  char *p;
+  for (a = 0; a < vocab_size; a++) {
+    for (p = vocab[a].word; *p; p++) hash = (hash ^ (unsigned char)*p) * 1099511628211ULL;
+    hash = (hash ^ (unsigned long long)vocab[a].cn) * 1099511628211ULL;
+  }
+  return (long long)hash;
+}
+
+// A failed write of the corpus cache (e.g. a full disk) removes the partial cache and stops
+void CacheWriteFailed(FILE *fo, char *cache_file) {
+  printf("ERROR: cannot write corpus cache %s\n", cache_file);
+  if (fo != NULL) fclose(fo);
+  unlink(cache_file);
+  exit(1);
+}
+
+void CacheWrite(const void *data, size_t size, size_t count, FILE *fo, char *cache_file) {
+  if (fwrite(data, size, count, fo) != count) CacheWriteFailed(fo, cache_file);
+}
+
+// Writes the training file as vocabulary indices; words not in the vocabulary are dropped,
+// exactly as TrainModelThread drops them
+void EncodeCorpus(char *cache_file, struct corpus_cache_header *header) {
+  long long a, word;
+  int *ids = (int *)malloc(READ_BUFFER_SIZE * sizeof(int));
+  struct word_reader *wr = OpenWordReader(train_file);
+  FILE *fo = fopen(cache_file, "wb");
+  if (wr == NULL) {
+    printf("ERROR: training data file not found!\n");
+    exit(1);
+  }
+  if (fo == NULL) {
+    printf("ERROR: cannot write corpus cache %s\n", cache_file);
+    exit(1);
+  }
+  // The magic is written last so that an interrupted encoding is never mistaken for a valid cache
+  memset(header->magic, 0, sizeof(header->magic));
+  header->words = 0;
+  header->vocab_bytes = 0;
+  CacheWrite(header, sizeof(struct corpus_cache_header), 1, fo, cache_file);
+  a = 0;
+  while (1) {
+    word = ReadWordIndex(wr);
+    if (wr->eof) break;
+    if (word == -1) continue;
+    ids[a++] = word;
+    if (a == READ_BUFFER_SIZE) {
+      CacheWrite(ids, sizeof(int), a, fo, cache_file);
+      header->words += a;
+      a = 0;
+    }
+  }
+  CacheWrite(ids, sizeof(int), a, fo, cache_file);
+  header->words += a;
+  header->vocab_bytes = 0;
+  for (a = 0; a < vocab_size; a++) {
+    CacheWrite(&vocab[a].cn, sizeof(long long), 1, fo, cache_file);
+    CacheWrite(vocab[a].word, 1, strlen(vocab[a].word) + 1, fo, cache_file);
+    header->vocab_bytes += sizeof(long long) + strlen(vocab[a].word) + 1;
+  }
+  memcpy(header->magic, "LMMIDX2", 8);
+  if (fseek(fo, 0, SEEK_SET) != 0) CacheWriteFailed(fo, cache_file);
+  CacheWrite(header, sizeof(struct corpus_cache_header), 1, fo, cache_file);
+  if (fclose(fo) != 0) CacheWriteFailed(NULL, cache_file);
+  CloseWordReader(wr);
+  free(ids);
+}
+
+// Reads the header of a complete corpus cache; returns 0 if there is none. A cache cut short (a full
+// disk, a copy that did not finish) still has a valid header, so its length is checked too; mapping
+// it would fault on the missing pages
+int ReadCacheHeader(char *cache_file, struct corpus_cache_header *stored) {
+  struct stat st;
+  int complete = 0;
+  FILE *fc = fopen(cache_file, "rb");
+  if (fc == NULL) return 0;
+  if (fread(stored, sizeof(struct corpus_cache_header), 1, fc) == 1 && fstat(fileno(fc), &st) == 0 &&
+      !memcmp(stored->magic, "LMMIDX2", 8) && stored->words >= 0 && stored->vocab_bytes >= 0 &&
+      st.st_size == sizeof(struct corpus_cache_header) + stored->words * (long long)sizeof(int) + stored->vocab_bytes) complete = 1;
+  fclose(fc);
+  return complete;
+}
+
+// Maps <train_file>.idx into memory, (re)building it first if it was encoded with another vocabulary,
+// min-count or version of the training file
+void LoadCorpusCache() {
+  char cache_file[MAX_STRING + 4];
+  struct corpus_cache_header header, stored;
+  struct stat st;
+  void *map;
+  int fd, valid = 0;
+  if (stat(train_file, &st) != 0) {
+    printf("ERROR: training data file not found!\n");
+    exit(1);
+  }
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "LMMIDX2", 8);
+  header.vocab_size = vocab_size;
+  header.min_count = min_count;
+  header.max_vocab = max_vocab_size;
+  header.vocab_checksum = VocabChecksum();
+  header.vocab_counted = read_vocab_file[0] == 0;
+  header.file_size = st.st_size;
+  header.file_mtime = st.st_mtime;
+  sprintf(cache_file, "%s.idx", train_file);
+  if (ReadCacheHeader(cache_file, &stored)) {
+    header.words = stored.words;
+    header.vocab_bytes = stored.vocab_bytes;
+    valid = !memcmp(&header, &stored, sizeof(header));
+  }
+  if (!valid) {
+    if (debug_mode > 0) printf("Encoding training file into %s\n", cache_file);
+    EncodeCorpus(cache_file, &header);
+  }
+  fd = open(cache_file, O_RDONLY);
+  if (fd < 0) {
+    printf("ERROR: cannot open corpus cache %s\n", cache_file);
+    exit(1);
+  }
+  map = mmap(NULL, sizeof(header) + header.words * sizeof(int), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    printf("ERROR: cannot map corpus cache %s\n", cache_file);
+    exit(1);
+  }
+  corpus_ids = (int *)((char *)map + sizeof(header));
+  corpus_words = header.words;
+  if (debug_mode > 0) printf("Training from corpus cache %s (%lld words)\n", cache_file, corpus_words);
+}
+
+// Takes the vocabulary from the corpus cache instead of counting the training file, if the cache
+// was encoded from the same version of the file with the same min-count and max-vocab. Returns 0
+// (and leaves the vocabulary empty) when the file has to be counted
+int LoadCachedVocab() {
+  char cache_file[MAX_STRING + 4], *data, *p, *end;
+  struct corpus_cache_header stored;
+  struct stat st;
+  long long a, cn;
+  FILE *fc;
+  int loaded = 0;
+  if (stat(train_file, &st) != 0) return 0;
+  sprintf(cache_file, "%s.idx", train_file);
+  if (!ReadCacheHeader(cache_file, &stored) || !stored.vocab_counted || stored.file_size != st.st_size ||
+      stored.file_mtime != st.st_mtime || stored.min_count != min_count || stored.max_vocab != max_vocab_size) return 0;
+  data = (char *)malloc(stored.vocab_bytes + 1);
+  fc = fopen(cache_file, "rb");
+  if (data == NULL || fc == NULL) {free(data); if (fc != NULL) fclose(fc); return 0;}
+  if (fseek(fc, sizeof(stored) + stored.words * sizeof(int), SEEK_SET) == 0 &&
+      fread(data, 1, stored.vocab_bytes, fc) == stored.vocab_bytes) {
+    ResetHashTable(&vocab_table, stored.vocab_size);
+    vocab_size = 0;
+    train_words = 0;
+    p = data;
+    end = data + stored.vocab_bytes;
+    data[stored.vocab_bytes] = 0;
+    // The words were written after SortVocab, so adding them in order rebuilds the same vocabulary
+    for (a = 0; a < stored.vocab_size && end - p > sizeof(long long); a++) {
+      memcpy(&cn, p, sizeof(long long));
+      p += sizeof(long long);
+      AddWordToVocab(p);
+      vocab[vocab_size - 1].cn = cn;
+      train_words += cn;
+      p += strlen(p) + 1;
+    }
+    loaded = vocab_size == stored.vocab_size && p == end && VocabChecksum() == stored.vocab_checksum;
+  }
+  fclose(fc);
+  free(data);
+  if (!loaded) {
+    FreeArena(&vocab_arena);
+    ResetHashTable(&vocab_table, 0);
+    vocab_size = 0;
+    train_words = 0;
+    return 0;
+  }
+  file_size = st.st_size;
+  if (debug_mode > 0) {
+    printf("Vocabulary taken from corpus cache %s\n", cache_file);
+    printf("Vocab size: %lld\n", vocab_size);
+    printf("Words in train file: %lld\n", train_words);
+  }
+	//modification begin
+	printf("[Debug] Load word map ...\n");
+	LoadMapData();
+  printf("[Debug] Load word map successfully!\n");
+	//modification end
+  return 1;
+}
+
+// Opens the part of the training data that thread 'id' trains on. With the corpus cache or
+// -mmap the parts are exact and start at a sentence boundary; otherwise the thread seeks into the text file
+struct word_reader *OpenThreadReader(long long id) {
+  long long begin, end;
+  struct word_reader *wr;
+  if (corpus_cache) {
+    begin = corpus_words / num_threads * id;
+    end = id == num_threads - 1 ? corpus_words : corpus_words / num_threads * (id + 1);
+    while (begin > 0 && begin < corpus_words && corpus_ids[begin - 1] != 0) begin++;
+    while (end > 0 && end < corpus_words && corpus_ids[end - 1] != 0) end++; // fewer words than threads leaves empty parts
+    wr = (struct word_reader *)calloc(1, sizeof(struct word_reader));
+    wr->ids = corpus_ids + begin;
+    wr->len = end - begin;
+    return wr;
+  }
+  if (mmap_input) return OpenMappedReader(id);
+  wr = OpenWordReader(train_file);
+  SeekWordReader(wr, file_size / (long long)num_threads * id);
+  return wr;
+}
+
+// Rewinds a thread's reader to the start of its part for the next iteration
+void ResetThreadReader(struct word_reader *wr, long long id) {
+  if (wr->fin != NULL) {
+    SeekWordReader(wr, file_size / (long long)num_threads * id);
+    return;
+  }
+  wr->pos = 0;
+  wr->eof = 0;
+}
+
+// The keep probability of each word depends only on its count, so it is turned once into a
+// 16-bit threshold. A word is dropped when ran < r / 65536 for the random r in [0, 65535]; since
+// ran * 65536 is exact in floating point, that is the same as r > floor(ran * 65536)
+void InitKeepProbabilities() {
+  long long a;
+  real ran;
+  a = posix_memalign((void **)&vocab_keep, 128, (long long)vocab_size * sizeof(unsigned short));
+  if (vocab_keep == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  for (a = 0; a < vocab_size; a++) {
+    if (sample > 0) ran = (sqrt(vocab[a].cn / (sample * train_words)) + 1) * (sample * train_words) / vocab[a].cn;
+    else ran = 1;
+    ran *= 65536;
+    vocab_keep[a] = ran >= 65535 ? 65535 : (unsigned short)floor(ran);
+  }
+}
+
+//modification begin
+// Recomputes the composed vectors of words first .. last - 1 from the current morpheme vectors.
+// During training this runs while the other threads read composed and add their incremental updates
+// to it, without locks, in the same Hogwild style as the updates of syn0. The race is intentional:
+// each row is built in sum (dim values) and only its final values are stored, so a reader sees old
+// or new elements but never a zeroed or undivided row, and an incremental update that lands during
+// the rebuild is lost from composed only until the next sweep, as syn0 already holds it
+void RefreshComposed(long long first, long long last, real *sum) {
+  long long w, c, curIdx, n;
+  for (w = first; w < last; w++) {
+    n = morph_offset[3 * w + 3] - morph_offset[3 * w];
+    if (n == 0) continue;
+    for (c = 0; c < dim; c++) sum[c] = 0;
+    for (curIdx = morph_offset[3 * w]; curIdx < morph_offset[3 * w + 3]; curIdx++)
+      KernelAxpy(1, syn0 + (long long)morph_index[curIdx] * dim, sum, dim);
+    for (c = 0; c < dim; c++) composed[c + w * dim] = sum[c] / n;
+  }
+}
+//modification end
+
+// Reads the CPUs the process may run on (taskset, cgroups) for -bind
+void InitBinding() {
+#ifdef __linux__
+  long long a;
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {printf("Cannot read the CPU affinity, -bind is ignored\n"); bind_threads = 0; return;}
+  bind_cpus = (int *)malloc(CPU_SETSIZE * sizeof(int));
+  for (a = 0; a < CPU_SETSIZE; a++) if (CPU_ISSET(a, &set)) bind_cpus[bind_cpu_count++] = a;
+#else
+  printf("-bind is only supported on Linux\n");
+  bind_threads = 0;
+#endif
+}
+
+// Pins the calling thread, the id-th of num_threads, to its CPU. InitNet and the training pin with
+// the same ids, so the buffers a training thread allocates stay on its own node
+void BindThread(long long id) {
+#ifdef __linux__
+  cpu_set_t set;
+  if (!bind_threads || bind_cpu_count == 0) return;
+  CPU_ZERO(&set);
+  if (bind_threads == 2 && num_threads < bind_cpu_count) CPU_SET(bind_cpus[id * bind_cpu_count / num_threads], &set);
+  else CPU_SET(bind_cpus[id % bind_cpu_count], &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+// next_random after steps more draws of the linear congruential generator, in O(log steps)
+unsigned long long SkipRandom(unsigned long long next_random, unsigned long long steps) {
+  unsigned long long mul = 1, add = 0, m = 25214903917, c = 11;
+  for (; steps; steps >>= 1) {
+    if (steps & 1) {
+      mul *= m;
+      add = add * m + c;
+    }
+    c *= m + 1;
+    m *= m;
+  }
+  return next_random * mul + add;
+}
+
+// Initializes one thread's slice of the weight matrices. Each page is placed on the node of the thread
+// that touches it first, so the matrices end up spread over the nodes block by block instead of on
+// one node. This is not locality: training reads and writes rows at random across the whole matrix,
+// so most accesses are remote either way. syn0 continues the single generator sequence from the
+// start of the slice, so the values do not depend on the number of threads
+void *InitNetThread(void *id) {
+  long long a, b, first = vocab_size * (long long)id / num_threads, last = vocab_size * ((long long)id + 1) / num_threads;
+  unsigned long long next_random = SkipRandom(1, first * dim);
+  BindThread((long long)id);
+  if (hs) for (a = first; a < last; a++) for (b = 0; b < dim; b++)
+    syn1[a * dim + b] = 0; // init parameter vector syn1
+  if (negative > 0) for (a = first; a < last; a++) for (b = 0; b < dim; b++)
+    syn1neg[a * dim + b] = 0; // init parameter vector syn1neg
+  for (a = first; a < last; a++) for (b = 0; b < dim; b++) {
+    next_random = next_random * (unsigned long long)25214903917 + 11;
+    syn0[a * dim + b] = (((next_random & 0xFFFF) / (real)65536) - 0.5) / dim;// init word vector syn0
+  }
+  pthread_exit(NULL);
+}
+
+//modification begin
+// Fills one thread's slice of composed, the same slice as in InitNetThread, so its pages are first
+// touched on the node of the thread that trains with them like those of the other matrices. This is a
+// second pass because the mean of a word's morphemes reads syn0 rows from every slice
+void *InitComposedThread(void *id) {
+  long long first = vocab_size * (long long)id / num_threads, last = vocab_size * ((long long)id + 1) / num_threads;
+  real *sum = (real *)malloc(dim * sizeof(real)); // scratch row of RefreshComposed
+  if (sum == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  BindThread((long long)id);
+  RefreshComposed(first, last, sum);
+  free(sum);
+  pthread_exit(NULL);
+}
+//modification end
+
+void InitNet() {
+  long long a;
+  pthread_t *pt = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+  a = posix_memalign((void **)&syn0, 128, (long long)vocab_size * dim * sizeof(real));
+  if (syn0 == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  if (hs) {// hierachical softmax
+    a = posix_memalign((void **)&syn1, 128, (long long)vocab_size * dim * sizeof(real));
+    if (syn1 == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  }
+  if (negative>0) { // negative sampling
+    a = posix_memalign((void **)&syn1neg, 128, (long long)vocab_size * dim * sizeof(real));
+    if (syn1neg == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  }
+  for (a = 0; a < num_threads; a++) pthread_create(&pt[a], NULL, InitNetThread, (void *)a);
+  for (a = 0; a < num_threads; a++) pthread_join(pt[a], NULL);
+  //modification begin
+  if (model == MODEL_A && compose_refresh != 0) {
+    a = posix_memalign((void **)&composed, 128, (long long)vocab_size * dim * sizeof(real));
+    if (composed == NULL) {printf("Memory allocation failed\n"); exit(1);}
+    for (a = 0; a < num_threads; a++) pthread_create(&pt[a], NULL, InitComposedThread, (void *)a);
+    for (a = 0; a < num_threads; a++) pthread_join(pt[a], NULL);
+  }
+  //modification end
+  free(pt);
+
+  CreateBinaryTree();
+  InitKeepProbabilities();
+}
+
+// Hierarchical softmax along the path of word. The nodes of a path are distinct and h does not
+// change, so all dot products go first, with the rows prefetched, then the updates of the nodes
+// that are not saturated. g has room for 2 * MAX_CODE_LENGTH values; the second half holds the
+// sigmoids of -fast-sigmoid
+void TrainHierarchical(real *h, real *neu1e, long long word, real **rows, real *g) {
+  long long d, i, k = 0, n = code_offset[word + 1] - code_offset[word];
+  real f;
+  for (i = 0; i < n; i++) {
+    rows[i] = syn1 + code_points[code_offset[word] + i] * dim;
+    for (d = 0; d < dim; d += 64 / sizeof(real)) __builtin_prefetch(rows[i] + d, 1);
+  }
+  KernelDotBatch(h, rows, g, n, dim); // Propagate hidden -> output
+  if (fast_sigmoid) KernelSigmoid(g, g + MAX_CODE_LENGTH, MAX_EXP, n);
+  for (i = 0; i < n; i++) {
+    f = g[i];
+    if (f <= -MAX_EXP) continue;
+    else if (f >= MAX_EXP) continue;
+    else if (f != f) continue; // NaN, from vectors that have diverged: it has no table entry
+    else if (fast_sigmoid) f = g[MAX_CODE_LENGTH + i];
+    else f = expTable[(int)((f + MAX_EXP) * (EXP_TABLE_SIZE / MAX_EXP / 2))];
+    // 'g' is the gradient multiplied by the learning rate
+    g[k] = (1 - code_bits[code_offset[word] + i] - f) * alpha;
+    rows[k++] = rows[i];
+  }
+  KernelDualUpdateBatch(g, neu1e, rows, h, k, dim); // Propagate errors output -> hidden and learn weights hidden -> output
+}
+
+// Handles one block of distinct negative sampling rows: all dot products with h first, then all
+// the updates
+void UpdateNegatives(real *h, real *neu1e, long long word, long long *targets, real **rows, real *g, long long k) {
+  long long i, label;
+  real f;
+  for (i = 0; i < k; i++) rows[i] = syn1neg + targets[i] * dim;
+  KernelDotBatch(h, rows, g, k, dim); //x^T_w * theta^u
+  if (fast_sigmoid) {
+    KernelSigmoid(g, g, MAX_EXP, k);
+    for (i = 0; i < k; i++) g[i] = ((targets[i] == word) - g[i]) * alpha;
+  } else for (i = 0; i < k; i++) {
+    f = g[i];
+    label = targets[i] == word;
+    if (f > MAX_EXP) g[i] = (label - 1) * alpha;
+    else if (f < -MAX_EXP) g[i] = (label - 0) * alpha;
+    else if (f != f) g[i] = 0; // NaN, from vectors that have diverged: it has no table entry
+    else g[i] = (label - expTable[(int)((f + MAX_EXP) * (EXP_TABLE_SIZE / MAX_EXP / 2))]) * alpha;
+  }
+  KernelDualUpdateBatch(g, neu1e, rows, h, k, dim); //e := e + g * theta^u, theta^u := theta^u + g * x_w
+}
+
+// Negative sampling for the hidden vector h of one position. The output word and its negatives are
+// gathered into blocks; a block ends before a row that is already in it, so every dot product sees
+// the same rows as when the rows are handled one after another
+void TrainNegatives(real *h, real *neu1e, long long word, struct neg_ring *ring, unsigned long long *next_random, long long *targets, real **rows, real *g) {
+  long long d, i, k = 0, target;
+  if (ring->size) PrefetchNegatives(ring, next_random);
+  for (d = 0; d < negative + 1; d++) {
+    if (d == 0) target = word;
+    else {
+      target = NextNegative(ring, next_random);
+      if (target == word) continue;
+    }
+    for (i = 0; i < k; i++) if (targets[i] == target) break;
+    if (i < k) {
+      UpdateNegatives(h, neu1e, word, targets, rows, g, k);
+      k = 0;
+    }
+    targets[k++] = target;
+  }
+  UpdateNegatives(h, neu1e, word, targets, rows, g, k);
+}
+
+//modification begin
+// L2 norm of syn0 row w. The norms are computed where they are used rather than cached next to
+// syn0: a cache would be written by every thread on every update of a row
+real RowNorm(long long w) {
+  return sqrt(KernelDot(syn0 + w * dim, syn0 + w * dim, dim));
+}
+
+// Recomputes the morpheme weights of this thread's share of the vocabulary. All threads sweep
+// their shares at about the same time, so together they refresh the whole weights array
+void RefreshMorphemeWeights(long long id) {
+  long long w, curIdx, end, k, i;
+  long long first = vocab_size * id / num_threads, last = vocab_size * (id + 1) / num_threads;
+  real *rows[16], sims[16], len;
+  for (w = first; w < last; w++) {
+    len = RowNorm(w);
+    end = morph_offset[3 * w + 3];
+    for (curIdx = morph_offset[3 * w]; curIdx < end; curIdx += k) {
+      k = end - curIdx < 16 ? end - curIdx : 16;
+      for (i = 0; i < k; i++) rows[i] = syn0 + (long long)morph_index[curIdx + i] * dim;
+      KernelDotBatch(syn0 + w * dim, rows, sims, k, dim);
+      for (i = 0; i < k; i++) {
+        sims[i] /= len * RowNorm(morph_index[curIdx + i]);
+        morph_weight[curIdx + i] = sims[i] < 0 ? -sims[i] : sims[i];
+      }
+    }
+  }
+}
+//modification end
+
+// Distinct syn0 rows of one hidden -> in step, each with the number of times it receives neu1e.
+// Words and morphemes that occur several times in a window are then written once
+struct scatter {
+  long long row[MAX_SCATTER];
+  real count[MAX_SCATTER];
+  int size;
+};
+
+//modification begin
+// in -> hidden for one context word of model A: writes to h its vector averaged with the mean of its
+// morphemes, or its own vector if it has none. comp is scratch space for 3 * dim values
+void ComposeWordA(long long last_word, real *h, real *comp, long long *pick) {
+  real *prefixComp = comp, *rootComp = comp + dim, *suffixComp = comp + 2 * dim, *morpheme = h;
+  long long c;
+  int pCnt, rCnt, sCnt; // count of each morpheme
+  int curIdx;
+  int pBegin, rBegin, sBegin; // start of each morpheme type of a word in morph_index
+  if (compose_refresh != 0) {
+    // one read of the cached morpheme mean instead of one per morpheme
+    if (morph_offset[3 * last_word + 3] > morph_offset[3 * last_word])
+      for (c = 0; c < dim; c++) h[c] = (syn0[c + last_word * dim] + composed[c + last_word * dim]) / 2;
+    else
+      for (c = 0; c < dim; c++) h[c] = syn0[c + last_word * dim];
+    return;
+  }
+
+  for (c = 0; c < dim; c++) morpheme[c] = 0;
+  for (c = 0; c < dim; c++) morpheme[c] = syn0[c + last_word * dim];
+
+  for (c = 0; c < dim; c++) { prefixComp[c] = 0; rootComp[c] = 0; suffixComp[c] = 0; }
+
+  pBegin = morph_offset[3 * last_word];
+  rBegin = morph_offset[3 * last_word + 1];
+  sBegin = morph_offset[3 * last_word + 2];
+  pCnt = rBegin - pBegin;
+  rCnt = sBegin - rBegin;
+  sCnt = morph_offset[3 * last_word + 3] - sBegin;
+
+  if(pCnt != 0){
+    for(curIdx = pBegin; curIdx < pBegin + pCnt; curIdx++){
+      long long prefixWord = morph_index[curIdx];
+      //printf("[Debug] TrainModelThread-prefix: %lld\n", prefixWord);
+      KernelAxpy(1, syn0 + prefixWord * dim, prefixComp, dim);
+    }
+  }
+
+  if(rCnt != 0){
+    for(curIdx = rBegin; curIdx < rBegin + rCnt; curIdx++){
+      long long rootWord = morph_index[curIdx];
+      //printf("[Debug] TrainModelThread-root: %lld\n", rootWord);
+      KernelAxpy(1, syn0 + rootWord * dim, rootComp, dim);
+    }
+  }
+
+  if(sCnt != 0){
+    for(curIdx = sBegin; curIdx < sBegin + sCnt; curIdx++){
+      long long suffixWord = morph_index[curIdx];
+      //printf("[Debug] TrainModelThread-suffix: %lld\n", suffixWord);
+      KernelAxpy(1, syn0 + suffixWord * dim, suffixComp, dim);
+    }
+  }
+
+  int norm = 1;
+  if(pCnt + rCnt + sCnt != 0){
+    for (c = 0; c < dim; c++)
+      morpheme[c] += (prefixComp[c] + rootComp[c] + suffixComp[c]) / (pCnt + rCnt + sCnt); //wegihted averaging
+    norm = 2;
+  }
+  for (c = 0; c < dim; c++) h[c] = morpheme[c] / norm;
+}
+
+// in -> hidden for one context word of model S: writes to h its vector averaged with the mean of its
+// morphemes weighted by their cosine similarity to it, or its own vector if it has none. comp is
+// scratch space for 3 * dim values
+void ComposeWordS(long long last_word, real *h, real *comp, long long *pick) {
+  real *prefixComp = comp, *rootComp = comp + dim, *suffixComp = comp + 2 * dim, *morpheme = h;
+  long long c;
+  int pCnt, rCnt, sCnt; // count of each morpheme
+  int curIdx;
+  int pBegin, rBegin, sBegin; // start of each morpheme type of a word in morph_index
+  real pWeight, rWeight, sWeight; // weight of each morpheme
+  real len, sim;
+  for (c = 0; c < dim; c++) morpheme[c] = 0;
+  for (c = 0; c < dim; c++) morpheme[c] = syn0[c + last_word * dim];
+
+  for (c = 0; c < dim; c++) { prefixComp[c] = 0; rootComp[c] = 0; suffixComp[c] = 0; }
+
+  pWeight = 0;
+  rWeight = 0;
+  sWeight = 0;
+
+  pBegin = morph_offset[3 * last_word];
+  rBegin = morph_offset[3 * last_word + 1];
+  sBegin = morph_offset[3 * last_word + 2];
+  pCnt = rBegin - pBegin;
+  rCnt = sBegin - rBegin;
+  sCnt = morph_offset[3 * last_word + 3] - sBegin;
+
+  // cosine similarities divide by the norms instead of normalizing copies of the vectors
+  len = RowNorm(last_word);
+
+  if(pCnt != 0){
+    for(curIdx = pBegin; curIdx < pBegin + pCnt; curIdx++){
+      long long prefixWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + prefixWord * dim, dim) / (len * RowNorm(prefixWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      //printf("[Debug] TrainModelThread-prefix: %lld\n", prefixWord);
+      KernelAxpy(sim, syn0 + prefixWord * dim, prefixComp, dim);
+      pWeight += sim;
+    }
+  }
+
+  if(rCnt != 0){
+    for(curIdx = rBegin; curIdx < rBegin + rCnt; curIdx++){
+      long long rootWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + rootWord * dim, dim) / (len * RowNorm(rootWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      //printf("[Debug] TrainModelThread-root: %lld\n", rootWord);
+      KernelAxpy(sim, syn0 + rootWord * dim, rootComp, dim);
+      rWeight += sim;
+    }
+  }
+
+  if(sCnt != 0){
+    for(curIdx = sBegin; curIdx < sBegin + sCnt; curIdx++){
+      long long suffixWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + suffixWord * dim, dim) / (len * RowNorm(suffixWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      //printf("[Debug] TrainModelThread-suffix: %lld\n", suffixWord);
+      KernelAxpy(sim, syn0 + suffixWord * dim, suffixComp, dim);
+      sWeight += sim;
+    }
+  }
+
+  int norm = 1;
+  real sumWeight = pWeight + rWeight + sWeight;
+  if(pCnt + rCnt + sCnt != 0){
+    for (c = 0; c < dim; c++)
+      morpheme[c] += (prefixComp[c] + rootComp[c] + suffixComp[c]) / sumWeight; //wegihted averaging
+    norm = 2;
+  }
+  for (c = 0; c < dim; c++) h[c] = morpheme[c] / norm;
+}
+
+// in -> hidden for one context word of model M: writes to h its vector averaged with the most similar
+// prefix, root and suffix, and stores those in pick[0 .. 2] (-1 if the word has none of a kind).
+// comp is scratch space for 3 * dim values
+void ComposeWordM(long long last_word, real *h, real *comp, long long *pick) {
+  real *prefixComp = comp, *rootComp = comp + dim, *suffixComp = comp + 2 * dim, *morpheme = h;
+  long long c;
+  int pCnt, rCnt, sCnt; // count of each morpheme
+  int curIdx;
+  int pBegin, rBegin, sBegin; // start of each morpheme type of a word in morph_index
+  real pMaxWeight, rMaxWeight, sMaxWeight; // weight of each morpheme
+  long long pMaxWord, rMaxWord, sMaxWord;
+  real len, sim;
+  for (c = 0; c < dim; c++) morpheme[c] = 0;
+  for (c = 0; c < dim; c++) morpheme[c] = syn0[c + last_word * dim];
+
+  for (c = 0; c < dim; c++) { prefixComp[c] = 0; rootComp[c] = 0; suffixComp[c] = 0; }
+
+  pMaxWeight = 0;
+  rMaxWeight = 0;
+  sMaxWeight = 0;
+
+  pMaxWord = 0;
+  rMaxWord = 0;
+  sMaxWord = 0;
+
+  pBegin = morph_offset[3 * last_word];
+  rBegin = morph_offset[3 * last_word + 1];
+  sBegin = morph_offset[3 * last_word + 2];
+  pCnt = rBegin - pBegin;
+  rCnt = sBegin - rBegin;
+  sCnt = morph_offset[3 * last_word + 3] - sBegin;
+
+  // cosine similarities divide by the norms instead of normalizing copies of the vectors
+  len = RowNorm(last_word);
+
+  if(pCnt != 0){
+    for(curIdx = pBegin; curIdx < pBegin + pCnt; curIdx++){
+      long long prefixWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + prefixWord * dim, dim) / (len * RowNorm(prefixWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      if(sim > pMaxWeight){
+        pMaxWeight = sim;
+        pMaxWord = prefixWord;
+      }
+    }
+    KernelAxpy(pMaxWeight, syn0 + pMaxWord * dim, prefixComp, dim);
+  }
+
+  if(rCnt != 0){
+    for(curIdx = rBegin; curIdx < rBegin + rCnt; curIdx++){
+      long long rootWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + rootWord * dim, dim) / (len * RowNorm(rootWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      if(sim > rMaxWeight){
+        rMaxWeight = sim;
+        rMaxWord = rootWord;
+      }
+    }
+    KernelAxpy(rMaxWeight, syn0 + rMaxWord * dim, rootComp, dim);
+  }
+
+  if(sCnt != 0){
+    for(curIdx = sBegin; curIdx < sBegin + sCnt; curIdx++){
+      long long suffixWord = morph_index[curIdx];
+
+      if (weight_refresh != 0) sim = morph_weight[curIdx]; // weight from the last sweep
+      else {
+        sim = KernelDot(morpheme, syn0 + suffixWord * dim, dim) / (len * RowNorm(suffixWord));
+        sim = sim < 0 ? -sim : sim;
+        //sim = (1 + sim) / 2.0;
+      }
+
+      if(sim > sMaxWeight){
+        sMaxWeight = sim;
+        sMaxWord = suffixWord;
+      }
+    }
+    KernelAxpy(sMaxWeight, syn0 + sMaxWord * dim, suffixComp, dim);
+  }
+  pick[0] = pCnt != 0 ? pMaxWord : -1;
+  pick[1] = rCnt != 0 ? rMaxWord : -1;
+  pick[2] = sCnt != 0 ? sMaxWord : -1;
+
+  int norm = 1;
+  real sumWeight = pMaxWeight + rMaxWeight + sMaxWeight;
+  if(pCnt + rCnt + sCnt != 0){
+    for (c = 0; c < dim; c++)
+      morpheme[c] += (prefixComp[c] + rootComp[c] + suffixComp[c]) / sumWeight; //wegihted averaging
+    norm = 2;
+  }
+  for (c = 0; c < dim; c++) h[c] = morpheme[c] / norm;
+}
+//modification end
+
+// Minibatched CBOW (-batch): consecutive centers of a sentence share one set of negatives, so the
+// output layer of a whole batch is two small matrix products instead of one dot/update pair per row
+struct cbow_batch {
+  real *h, *e;             // hidden vector and error of each center, one row per center
+  real **h_rows, **e_rows;
+  long long *word, *position, *reduced; // center word, its position in the sentence and its window reduction
+  long long *targets;      // shared negatives
+  real **rows, *f, *g, *gt; // output rows; dot products, and gradients per center and per row
+  long long *choice;       // morphemes picked for the context words of each center, see UpdateContext
+  real *sum;               // scratch row of RefreshComposed (-compose-refresh)
+  long long size;
+};
+
+void InitBatch(struct cbow_batch *bt) {
+  long long i;
+  bt->h = (real *)malloc(batch * dim * sizeof(real));
+  bt->e = (real *)malloc(batch * dim * sizeof(real));
+  bt->h_rows = (real **)malloc(batch * sizeof(real *));
+  bt->e_rows = (real **)malloc(batch * sizeof(real *));
+  bt->word = (long long *)malloc(batch * sizeof(long long));
+  bt->position = (long long *)malloc(batch * sizeof(long long));
+  bt->reduced = (long long *)malloc(batch * sizeof(long long));
+  bt->targets = (long long *)malloc(negative * sizeof(long long));
+  bt->rows = (real **)malloc((negative + 1) * sizeof(real *));
+  bt->f = (real *)malloc(batch * (negative + 1) * sizeof(real));
+  bt->g = (real *)malloc(batch * (negative + 1) * sizeof(real));
+  bt->gt = (real *)malloc(batch * sizeof(real));
+  bt->choice = (long long *)malloc(batch * 3 * (window * 2 + 1) * sizeof(long long));
+  bt->sum = (real *)malloc(dim * sizeof(real));
+  if (bt->h == NULL || bt->e == NULL || bt->f == NULL || bt->g == NULL) {printf("Memory allocation failed\n"); exit(1);}
+  for (i = 0; i < batch; i++) {
+    bt->h_rows[i] = bt->h + i * dim;
+    bt->e_rows[i] = bt->e + i * dim;
+  }
+  bt->size = 0;
+}
+
+void FreeBatch(struct cbow_batch *bt) {
+  free(bt->h);
+  free(bt->e);
+  free(bt->h_rows);
+  free(bt->e_rows);
+  free(bt->word);
+  free(bt->position);
+  free(bt->reduced);
+  free(bt->targets);
+  free(bt->rows);
+  free(bt->f);
+  free(bt->g);
+  free(bt->gt);
+  free(bt->choice);
+  free(bt->sum);
+}
+
+// Negative sampling for all centers of a batch. Row 0 of center i is its own word and rows 1..negative
+// are the shared negatives; a negative equal to the center word gets no gradient for that center.
+// All errors are taken against the rows as they were before the batch, then the rows are updated
+void TrainBatch(struct cbow_batch *bt, unsigned long long *next_random) {
+  long long i, j, d, k = negative + 1, label;
+  real f, *g;
+  for (d = 0; d < negative; d++) {
+    *next_random = *next_random * (unsigned long long)25214903917 + 11;
+    bt->targets[d] = SampleUnigram(*next_random);
+    if (bt->targets[d] == 0) bt->targets[d] = *next_random % (vocab_size - 1) + 1;
+    bt->rows[d + 1] = syn1neg + bt->targets[d] * dim;
+  }
+  for (i = 0; i < bt->size; i++) {
+    bt->rows[0] = syn1neg + bt->word[i] * dim;
+    KernelDotBatch(bt->h_rows[i], bt->rows, bt->f + i * k, k, dim); //x^T_w * theta^u
+    g = bt->g + i * k;
+    if (fast_sigmoid) {
+      KernelSigmoid(bt->f + i * k, g, MAX_EXP, k);
+      for (j = 0; j < k; j++) g[j] = j > 0 && bt->targets[j - 1] == bt->word[i] ? 0 : ((j == 0) - g[j]) * alpha;
+    } else for (j = 0; j < k; j++) {
+      f = bt->f[i * k + j];
+      label = j == 0;
+      if (j > 0 && bt->targets[j - 1] == bt->word[i]) g[j] = 0;
+      else if (f > MAX_EXP) g[j] = (label - 1) * alpha;
+      else if (f < -MAX_EXP) g[j] = (label - 0) * alpha;
+      else if (f != f) g[j] = 0; // NaN, from vectors that have diverged: it has no table entry
+      else g[j] = (label - expTable[(int)((f + MAX_EXP) * (EXP_TABLE_SIZE / MAX_EXP / 2))]) * alpha;
+    }
+    KernelCombine(g, bt->rows, bt->e_rows[i], k, dim); //e := e + g * theta^u
+  }
+  // theta^u := theta^u + sum of g * x_w over the centers
+  for (i = 0; i < bt->size; i++) KernelAxpy(bt->g[i * k], bt->h_rows[i], syn1neg + bt->word[i] * dim, dim);
+  for (j = 1; j < k; j++) {
+    for (i = 0; i < bt->size; i++) bt->gt[i] = bt->g[i * k + j];
+    KernelCombine(bt->gt, bt->h_rows, bt->rows[j], bt->size, dim);
+  }
+}
+
+// The training loop is compiled once per strategy from lmm-strategy.h, so the morpheme handling of
+// every token is a direct call with no test of the model
+#define STRATEGY(name) name##A
+#define STRATEGY_MODEL MODEL_A
+#include "lmm-strategy.h"
+#undef STRATEGY
+#undef STRATEGY_MODEL
+
+#define STRATEGY(name) name##S
+#define STRATEGY_MODEL MODEL_S
+#include "lmm-strategy.h"
+#undef STRATEGY
+#undef STRATEGY_MODEL
+
+#define STRATEGY(name) name##M
+#define STRATEGY_MODEL MODEL_M
+#include "lmm-strategy.h"
+#undef STRATEGY
+#undef STRATEGY_MODEL
+
+void TrainModel() {
+  long a, b, c, d;
+  FILE *fo;
+  pthread_t *pt = (pthread_t *)malloc(num_threads * sizeof(pthread_t));
+  printf("Starting training using file %s\n", train_file);
+  if (debug_mode > 1) printf("Using %s kernels\n", kernel_name);
+  if (debug_mode > 1) printf("Using model %c\n", "ASM"[model]);
+  starting_alpha = alpha;
+  if (read_vocab_file[0] != 0) ReadVocab();
+  else if (!corpus_cache || !LoadCachedVocab()) LearnVocabFromTrainFile();
+  if (save_vocab_file[0] != 0) SaveVocab();
+  if (debug_mode > 2) ReportHashStats();
+  //modification begin
+  if (wordmap_file[0] == 0 || output_file[0] == 0) return;
+  //modification end
+  if (morph_offset == NULL) morph_offset = (int *)calloc(3 * vocab_size + 1, sizeof(int)); // no word map was loaded (-read-vocab)
+  if (corpus_cache) LoadCorpusCache();
+  else if (mmap_input) MapTrainFile();
+  InitNet();
+  if (negative > 0) InitUnigramTable();
+  if (negative > 0 && debug_mode > 2) ReportSamplerStats();
+  start = clock();
+  for (a = 0; a < num_threads; a++) pthread_create(&pt[a], NULL, model == MODEL_A ? TrainModelThreadA : (model == MODEL_S ? TrainModelThreadS : TrainModelThreadM), (void *)a); //create num_threads training thread
+  for (a = 0; a < num_threads; a++) pthread_join(pt[a], NULL);
+  fo = fopen(output_file, "wb");
+  if (classes == 0) {
+    // Save the word vectors
+	  //modification begin
+    //fprintf(fo, "%lld %lld\n", vocab_size, dim); //disable the input of vocab_size and dim
+	  //modification end
+    for (a = 0; a < vocab_size; a++) {
+      fprintf(fo, "%s ", vocab[a].word);
+      if (binary) for (b = 0; b < dim; b++) fwrite(&syn0[a * dim + b], sizeof(real), 1, fo);
+      else for (b = 0; b < dim; b++) fprintf(fo, "%lf ", syn0[a * dim + b]);
+      fprintf(fo, "\n");
+    }
+
+  } else {
+    // Run K-means on the word vectors
+    int clcn = classes, iter = 10, closeid;
+    int *centcn = (int *)malloc(classes * sizeof(int));
+    int *cl = (int *)calloc(vocab_size, sizeof(int));
+    real closev, x;
+    real *cent = (real *)calloc(classes * dim, sizeof(real));
+    for (a = 0; a < vocab_size; a++) cl[a] = a % clcn;
+    for (a = 0; a < iter; a++) {
+      for (b = 0; b < clcn * dim; b++) cent[b] = 0;
+      for (b = 0; b < clcn; b++) centcn[b] = 1;
+      for (c = 0; c < vocab_size; c++) {
+        for (d = 0; d < dim; d++) cent[dim * cl[c] + d] += syn0[c * dim + d];
+        centcn[cl[c]]++;
+      }
+      for (b = 0; b < clcn; b++) {
+        closev = 0;
+        for (c = 0; c < dim; c++) {
+          cent[dim * b + c] /= centcn[b];
+          closev += cent[dim * b + c] * cent[dim * b + c];
+        }
+        closev = sqrt(closev);
+        for (c = 0; c < dim; c++) cent[dim * b + c] /= closev;
+      }
+      for (c = 0; c < vocab_size; c++) {
+        closev = -10;
+        closeid = 0;
+        for (d = 0; d < clcn; d++) {
+          x = 0;
+          for (b = 0; b < dim; b++) x += cent[dim * d + b] * syn0[c * dim + b];
+          if (x > closev) {
+            closev = x;
+            closeid = d;
+          }
+        }
+        cl[c] = closeid;
+      }
+    }
+    // Save the K-means classes
+    for (a = 0; a < vocab_size; a++) fprintf(fo, "%s %d\n", vocab[a].word, cl[a]);
+    free(centcn);
+    free(cent);
+    free(cl);
+  }
+  //modification begin
+  //FreeMap();
+  //modification end
+  fclose(fo);
+}
+
+int ArgPos(char *str, int argc, char **argv) {
+  int a;
+  for (a = 1; a < argc; a++) if (!strcmp(str, argv[a])) {
+    if (a == argc - 1) {
+      printf("Argument missing for %s\n", str);
+      exit(1);
+    }
+    return a;
+  }
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  int i;
+  if (argc == 1) {
+    printf("WORD VECTOR estimation toolkit v 0.1c\n\n");
+    printf("Options:\n");
+    printf("Parameters for training:\n");
+    printf("\t-train <file>\n");
+    printf("\t\tUse text data from <file> to train the model\n");
+    //modification begin
+    printf("\t-refvocab <file>\n");
+    printf("\t\tUse reference vocabulary from <file> to calculate cosine similarity\n");
+    printf("\t-wordmap <file>\n");
+    printf("\t\tUse text data from <file> to map the target word\n");
+    //modification end
+    printf("\t-output <file>\n");
+    printf("\t\tUse <file> to save the resulting word vectors / word clusters\n");
+    printf("\t-size <int>\n");
+    printf("\t\tSet size of word vectors; default is 100\n");
+    printf("\t-window <int>\n");
+    printf("\t\tSet max skip length between words; default is 5\n");
+    printf("\t-sample <float>\n");
+    printf("\t\tSet threshold for occurrence of words. Those that appear with higher frequency in the training data\n");
+    printf("\t\twill be randomly down-sampled; default is 1e-3, useful range is (0, 1e-5)\n");
+    printf("\t-hs <int>\n");
+    printf("\t\tUse Hierarchical Softmax; default is 0 (not used)\n");
+    printf("\t-negative <int>\n");
+    printf("\t\tNumber of negative examples; default is 5, common values are 3 - 10 (0 = not used)\n");
+    printf("\t-threads <int>\n");
+    printf("\t\tUse <int> threads (default 12)\n");
+    printf("\t-iter <int>\n");
+    printf("\t\tRun more training iterations (default 5)\n");
+    printf("\t-min-count <int>\n");
+    printf("\t\tThis will discard words that appear less than <int> times; default is 5\n");
+    printf("\t-max-vocab <int>\n");
+    printf("\t\tPrune the rarest words whenever the vocabulary grows past <int> words while it is being counted;\n");
+    printf("\t\teach counting thread keeps at most <int> / threads words; default is 0 (no limit)\n");
+    printf("\t-alpha <float>\n");
+    printf("\t\tSet the starting learning rate; default is 0.025 for skip-gram and 0.05 for CBOW\n");
+    printf("\t-classes <int>\n");
+    printf("\t\tOutput word classes rather than word vectors; default number of classes is 0 (vectors are written)\n");
+    printf("\t-debug <int>\n");
+    printf("\t\tSet the debug mode (default = 2 = more info during training)\n");
+    printf("\t-binary <int>\n");
+    printf("\t\tSave the resulting vectors in binary moded; default is 0 (off)\n");
+    printf("\t-save-vocab <file>\n");
+    printf("\t\tThe vocabulary will be saved to <file>\n");
+    printf("\t-read-vocab <file>\n");
+    printf("\t\tThe vocabulary will be read from <file>, not constructed from the training data\n");
+    printf("\t-cbow <int>\n");
+    printf("\t\tUse the continuous bag of words model; default is 1 (use 0 for skip-gram model)\n");
+    printf("\t-cache <int>\n");
+    printf("\t\tEncode the training data and its vocabulary once into <file>.idx and train from it; later runs\n");
+    printf("\t\tskip counting the text. The file is rebuilt when the training file, the vocabulary, min-count or\n");
+    printf("\t\tmax-vocab changes; default is 0 (off)\n");
+    printf("\t-mmap <int>\n");
+    printf("\t\tMap the training file into memory and give each thread an exact, line-aligned part of it;\n");
+    printf("\t\tdefault is 0 (off)\n");
+    printf("\t-model <name>\n");
+    printf("\t\tMorpheme strategy: a (average), s (similarity weighted) or m (most similar morpheme); default is %c\n", "asm"[LMM_MODEL]);
+    printf("\t-compose-refresh <int>\n");
+    printf("\t\tModel a: cache the mean morpheme vector of every word and recompute the cache in one parallel sweep\n");
+    printf("\t\tevery <int> words; -1 sweeps once per iteration; default is 0 (sum the morphemes on every occurrence)\n");
+    printf("\t-weight-refresh <int>\n");
+    printf("\t\tModels s and m: recompute all word-morpheme weights in one parallel sweep every <int> words and use\n");
+    printf("\t\tthose weights in between; -1 sweeps once per iteration; default is 0 (compute them on every occurrence)\n");
+    printf("\t-batch <int>\n");
+    printf("\t\tTrain CBOW in batches of <int> consecutive centers that share one set of negative samples;\n");
+    printf("\t\tdefault is 0 (off, every center draws its own negatives)\n");
+    printf("\t-ns-power <float>\n");
+    printf("\t\tNegative samples are drawn in proportion to word count ^ <float>; default is 0.75\n");
+    printf("\t-ns-buffer <int>\n");
+    printf("\t\tDraw negative samples <int> at a time into a per-thread buffer and prefetch the output rows of\n");
+    printf("\t\tthe next step; at least 2 * negative, not used with -batch; default is 0 (draw when used)\n");
+    printf("\t-fast-sigmoid <int>\n");
+    printf("\t\tEvaluate the sigmoid of the output layer with a vectorized polynomial instead of the lookup table;\n");
+    printf("\t\tdefault is 0 (table)\n");
+    printf("\t-bind <int>\n");
+    printf("\t\tPin the threads to CPUs: 1 puts thread i on the i-th CPU the process may use, 2 spreads the threads\n");
+    printf("\t\tevenly over those CPUs (across sockets when they are numbered by socket); default is 0 (no pinning)\n");
+    printf("\t-kernel <name>\n");
+    printf("\t\tVector kernels of the training loops: scalar, avx2, avx512 or auto; default is auto (the widest\n");
+    printf("\t\tset the CPU supports)\n");
+    printf("\nExamples:\n");
+    //modification begin
+    printf("./lmm -model a -train data.txt -wordmap wordmap.txt -output vec.txt -size 200 -window 5 -sample 1e-4 -negative 5 -hs 0 -binary 0 -cbow 1 -iter 3\n\n");
+    //modification end
+    return 0;
+  }
+  //modification begin
+  wordmap_file[0] = 0;
+  //modification end
+  output_file[0] = 0;
+  save_vocab_file[0] = 0;
+  read_vocab_file[0] = 0;
+  if ((i = ArgPos((char *)"-size", argc, argv)) > 0) dim = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-train", argc, argv)) > 0) strcpy(train_file, argv[i + 1]);
+  if ((i = ArgPos((char *)"-save-vocab", argc, argv)) > 0) strcpy(save_vocab_file, argv[i + 1]);
+  if ((i = ArgPos((char *)"-read-vocab", argc, argv)) > 0) strcpy(read_vocab_file, argv[i + 1]);
+  if ((i = ArgPos((char *)"-debug", argc, argv)) > 0) debug_mode = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-binary", argc, argv)) > 0) binary = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-cbow", argc, argv)) > 0) cbow = atoi(argv[i + 1]);
+  if (cbow) alpha = 0.05;
+  if ((i = ArgPos((char *)"-alpha", argc, argv)) > 0) alpha = atof(argv[i + 1]);
+  //modification begin
+  if ((i = ArgPos((char *)"-wordmap", argc, argv)) > 0) strcpy(wordmap_file, argv[i + 1]);
+  if ((i = ArgPos((char *)"-model", argc, argv)) > 0) {
+    if (!strcmp(argv[i + 1], "a")) model = MODEL_A;
+    else if (!strcmp(argv[i + 1], "s")) model = MODEL_S;
+    else if (!strcmp(argv[i + 1], "m")) model = MODEL_M;
+    else {printf("Unknown model %s\n", argv[i + 1]); exit(1);}
+  }
+  if ((i = ArgPos((char *)"-compose-refresh", argc, argv)) > 0) compose_refresh = atoll(argv[i + 1]);
+  if ((i = ArgPos((char *)"-weight-refresh", argc, argv)) > 0) weight_refresh = atoll(argv[i + 1]);
+  if (compose_refresh != 0 && model != MODEL_A) {
+    printf("-compose-refresh is only used by model a\n");
+    compose_refresh = 0;
+  }
+  if (weight_refresh != 0 && model == MODEL_A) {
+    printf("-weight-refresh is only used by models s and m\n");
+    weight_refresh = 0;
+  }
+  //modification end
+  if ((i = ArgPos((char *)"-output", argc, argv)) > 0) strcpy(output_file, argv[i + 1]);
+  if ((i = ArgPos((char *)"-window", argc, argv)) > 0) window = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-sample", argc, argv)) > 0) sample = atof(argv[i + 1]);
+  if ((i = ArgPos((char *)"-hs", argc, argv)) > 0) hs = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-negative", argc, argv)) > 0) negative = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-threads", argc, argv)) > 0) num_threads = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-iter", argc, argv)) > 0) iter = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-min-count", argc, argv)) > 0) min_count = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-max-vocab", argc, argv)) > 0) max_vocab_size = atoll(argv[i + 1]);
+  if ((i = ArgPos((char *)"-classes", argc, argv)) > 0) classes = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-cache", argc, argv)) > 0) corpus_cache = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-mmap", argc, argv)) > 0) mmap_input = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-ns-power", argc, argv)) > 0) ns_power = atof(argv[i + 1]);
+  if ((i = ArgPos((char *)"-ns-buffer", argc, argv)) > 0) ns_buffer = atoll(argv[i + 1]);
+  if (ns_buffer > 0 && ns_buffer < 2 * negative) ns_buffer = 2 * negative;
+  if (ns_buffer < 0) ns_buffer = 0;
+  if ((i = ArgPos((char *)"-fast-sigmoid", argc, argv)) > 0) fast_sigmoid = atoi(argv[i + 1]);
+  if ((i = ArgPos((char *)"-bind", argc, argv)) > 0) bind_threads = atoi(argv[i + 1]);
+  if (bind_threads) InitBinding();
+  if ((i = ArgPos((char *)"-batch", argc, argv)) > 0) batch = atoi(argv[i + 1]);
+  if (batch > 1 && (!cbow || negative == 0)) {
+    printf("-batch is only used for CBOW with negative sampling\n");
+    batch = 0;
+  }
+  if ((i = ArgPos((char *)"-kernel", argc, argv)) > 0) {
+    if (!SelectKernels(argv[i + 1])) {printf("Kernel set %s is not supported\n", argv[i + 1]); exit(1);}
+  } else SelectKernels("auto");
+
+  vocab = (struct vocab_word *)calloc(vocab_max_size, sizeof(struct vocab_word));
+  InitHashTable(&vocab_table, vocab_max_size);
+
+  expTable = (real *)malloc((EXP_TABLE_SIZE + 1) * sizeof(real));
+  for (i = 0; i < EXP_TABLE_SIZE; i++) {
+    expTable[i] = exp((i / (real)EXP_TABLE_SIZE * 2 - 1) * MAX_EXP); // Precompute the exp() table
+    expTable[i] = expTable[i] / (expTable[i] + 1);                   // Precompute f(x) = 1/(1+e^(-x)) = e^x / (e^x + 1)
+  }
+  TrainModel();
+  return 0;
+}